@@ -0,0 +1,30 @@
+#include "pch.h"
+
+#include <cstdint>
+
+#include "Arena.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+Arena::Arena(size_t bytes)
+  : _memory(new char[bytes])
+  , _capacity(bytes)
+  , _used(0)
+{ }
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+  ARC_ASSERT((alignment & (alignment - 1)) == 0);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(_memory.get());
+  size_t used = _used.load(memory_order_relaxed);
+  while (true) {
+    const uintptr_t start = (base + used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    const size_t end = static_cast<size_t>(start - base) + bytes;
+    if (end > _capacity) {
+      return nullptr;
+    }
+    if (_used.compare_exchange_weak(used, end, memory_order_relaxed)) {
+      return reinterpret_cast<void*>(start);
+    }
+  }
+}
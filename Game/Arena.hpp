@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "Util/Arc_Assert.hpp"
+
+namespace Quoridor {
+
+  // Bump allocator over one fixed block. Allocation is a pointer increment and nothing is ever freed
+  // individually, the whole block is reset at once. Only for trivially destructible types, since
+  // reset runs no destructors. Any number of threads may allocate at once, reset must not overlap
+  // with allocation.
+  class Arena {
+  public:
+    explicit Arena(size_t bytes);
+
+    // Null when the block is used up.
+    void* allocate(size_t bytes, size_t alignment);
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+      static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destroyed");
+      void* memory = allocate(sizeof(T) * count, alignof(T));
+      if (memory == nullptr) {
+        return nullptr;
+      }
+      T* items = static_cast<T*>(memory);
+      for (size_t i = 0; i < count; ++i) {
+        new (&items[i]) T();
+      }
+      return items;
+    }
+
+    inline void reset() {
+      _used.store(0, std::memory_order_relaxed);
+    }
+
+    inline size_t used() const {
+      return _used.load(std::memory_order_relaxed);
+    }
+    inline size_t capacity() const {
+      return _capacity;
+    }
+  private:
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    std::unique_ptr<char[]> _memory;
+    size_t _capacity;
+    std::atomic<size_t> _used;
+  };
+}
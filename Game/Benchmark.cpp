@@ -0,0 +1,146 @@
+#include "pch.h"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#include "Benchmark.hpp"
+#include "MctsEnsemble.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+vector<Board> Quoridor::benchmarkPositions() {
+  vector<Board> positions;
+  Board board;
+  positions.push_back(board);
+
+  // Both pawns advance and each side puts up a couple of walls in front of the other.
+  const Move middleGame[] = {
+    Move(PLAYER_ONE, DOWN),
+    Move(PLAYER_TWO, UP),
+    Move(PLAYER_ONE, DOWN),
+    Move(PLAYER_TWO, UP),
+    Move(PLAYER_ONE, PLACE_HORIZONAL_WALL, Point(3, 5)),
+    Move(PLAYER_TWO, PLACE_HORIZONAL_WALL, Point(4, 2)),
+    Move(PLAYER_ONE, PLACE_VERTICAL_WALL, Point(5, 5)),
+    Move(PLAYER_TWO, LEFT),
+  };
+  for (const Move& move : middleGame) {
+    board.doMove(move);
+  }
+  positions.push_back(board);
+
+  const Move lateGame[] = {
+    Move(PLAYER_ONE, LEFT),
+    Move(PLAYER_TWO, PLACE_HORIZONAL_WALL, Point(0, 3)),
+    Move(PLAYER_ONE, PLACE_HORIZONAL_WALL, Point(1, 5)),
+    Move(PLAYER_TWO, PLACE_VERTICAL_WALL, Point(4, 3)),
+  };
+  for (const Move& move : lateGame) {
+    board.doMove(move);
+  }
+  positions.push_back(board);
+
+  // Player one has spent every wall on the right hand side while player two stepped back and forth,
+  // so below the root player one's nodes are pawn races with player two's walls still to come.
+  Board outOfWalls;
+  for (int placed = 0; placed < STARTING_WALL_COUNTS; ++placed) {
+    outOfWalls.doMove(Move(PLAYER_ONE, PLACE_VERTICAL_WALL, Point(5 + placed / 4, 2 * (placed % 4))));
+    outOfWalls.doMove(Move(PLAYER_TWO, placed % 2 == 0 ? LEFT : RIGHT));
+  }
+  positions.push_back(outOfWalls);
+  return positions;
+}
+
+// Runs every position for each thread count and fills in the ratios against the first sample.
+template <typename Searcher, typename Limits, typename CountOf>
+static vector<ScalingSample> measure(const Searcher& searcher, const vector<Board>& positions,
+  const vector<int>& threadCounts, const Limits& limits, CountOf countOf) {
+  vector<ScalingSample> samples;
+  for (int threads : threadCounts) {
+    ScalingSample sample;
+    sample.threads = threads;
+    sample.seconds = 0;
+    sample.nodes = 0;
+    for (const Board& position : positions) {
+      const auto result = searcher(threads, position, limits);
+      sample.seconds += result.seconds;
+      sample.nodes += countOf(result);
+    }
+    sample.nodesPerSecond = sample.seconds > 0 ? sample.nodes / sample.seconds : 0;
+    sample.speedup = 1;
+    sample.nodesPerSecondScaling = 1;
+    if (!samples.empty() && sample.seconds > 0 && samples.front().nodesPerSecond > 0) {
+      sample.speedup = samples.front().seconds / sample.seconds;
+      sample.nodesPerSecondScaling = sample.nodesPerSecond / samples.front().nodesPerSecond;
+    }
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+vector<ScalingSample> Quoridor::measureScaling(const ParallelSearcher& searcher, const vector<Board>& positions,
+  const vector<int>& threadCounts, const SearchLimits& limits) {
+  return measure(searcher, positions, threadCounts, limits, [](const SearchResult& result) {
+    return result.nodes;
+  });
+}
+
+vector<ScalingSample> Quoridor::measureScaling(const MctsSearcher& searcher, const vector<Board>& positions,
+  const vector<int>& threadCounts, const MctsLimits& limits) {
+  return measure(searcher, positions, threadCounts, limits, [](const MctsResult& result) {
+    return result.simulations;
+  });
+}
+
+void Quoridor::writeScalingReport(ostream& out, const string& title, const vector<ScalingSample>& samples,
+  const string& countName) {
+  // Formatted on the side so the caller's stream keeps its own flags and precision.
+  ostringstream report;
+  report << title << "\n";
+  report << setw(8) << "threads" << setw(12) << "seconds" << setw(14) << countName << setw(14) << countName + "/sec"
+    << setw(10) << "speedup" << setw(12) << "nps scale" << "\n";
+  for (const ScalingSample& sample : samples) {
+    report << setw(8) << sample.threads
+      << setw(12) << fixed << setprecision(3) << sample.seconds
+      << setw(14) << sample.nodes
+      << setw(14) << setprecision(0) << sample.nodesPerSecond
+      << setw(10) << setprecision(2) << sample.speedup
+      << setw(12) << setprecision(2) << sample.nodesPerSecondScaling << "\n";
+  }
+  out << report.str();
+}
+
+ParallelSearcher Quoridor::parallelSearcher(ParallelSearchMode mode, size_t transpositionTableMegabytes) {
+  return [mode, transpositionTableMegabytes](int threads, const Board& board, const SearchLimits& limits) {
+    ParallelSearch search(mode, threads, transpositionTableMegabytes);
+    return search.search(board, limits);
+  };
+}
+
+void Quoridor::compareParallelSearches(ostream& out, const vector<int>& threadCounts, const SearchLimits& limits) {
+  const vector<Board> positions = benchmarkPositions();
+  writeScalingReport(out, "Lazy SMP", measureScaling(parallelSearcher(LAZY_SMP), positions, threadCounts, limits));
+  writeScalingReport(out, "ABDADA", measureScaling(parallelSearcher(ABDADA), positions, threadCounts, limits));
+}
+
+MctsSearcher Quoridor::sharedTreeSearcher(size_t arenaMegabytes) {
+  return [arenaMegabytes](int threads, const Board& board, const MctsLimits& limits) {
+    MctsEngine engine(arenaMegabytes, threads);
+    return engine.search(board, limits);
+  };
+}
+
+MctsSearcher Quoridor::rootParallelSearcher(size_t arenaMegabytesPerTree) {
+  return [arenaMegabytesPerTree](int threads, const Board& board, const MctsLimits& limits) {
+    MctsEnsemble ensemble(threads, arenaMegabytesPerTree);
+    return ensemble.search(board, limits);
+  };
+}
+
+void Quoridor::compareMctsModes(ostream& out, const vector<int>& threadCounts, const MctsLimits& limits) {
+  const vector<Board> positions = benchmarkPositions();
+  writeScalingReport(out, "MCTS shared tree", measureScaling(sharedTreeSearcher(), positions, threadCounts, limits), "sims");
+  writeScalingReport(out, "MCTS root parallel", measureScaling(rootParallelSearcher(), positions, threadCounts, limits), "sims");
+}
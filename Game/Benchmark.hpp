@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Board.hpp"
+#include "Mcts.hpp"
+#include "ParallelSearch.hpp"
+#include "Search.hpp"
+
+namespace Quoridor {
+
+  // Runs one search with the given number of threads.
+  typedef std::function<SearchResult(int threads, const Board& board, const SearchLimits& limits)> ParallelSearcher;
+
+  // Runs one MCTS search with the given number of threads.
+  typedef std::function<MctsResult(int threads, const Board& board, const MctsLimits& limits)> MctsSearcher;
+
+  // Totals over a set of positions for one thread count.
+  struct ScalingSample {
+    int threads;
+    double seconds;
+    // Simulations rather than nodes when measuring MCTS.
+    uint64_t nodes;
+    double nodesPerSecond;
+    // Time to finish the searches with one thread (the first sample) divided by the time here.
+    double speedup;
+    double nodesPerSecondScaling;
+  };
+
+  // A fixed set of opening, middle game and out of walls positions to benchmark on.
+  std::vector<Board> benchmarkPositions();
+
+  // Searches every position with each thread count in turn. Fixed depth limits measure time to depth,
+  // which is what speedup means here.
+  std::vector<ScalingSample> measureScaling(const ParallelSearcher& searcher, const std::vector<Board>& positions,
+    const std::vector<int>& threadCounts, const SearchLimits& limits);
+
+  // Searches every position with each thread count in turn, counting simulations. A simulation limit
+  // measures time to a fixed amount of work.
+  std::vector<ScalingSample> measureScaling(const MctsSearcher& searcher, const std::vector<Board>& positions,
+    const std::vector<int>& threadCounts, const MctsLimits& limits);
+
+  void writeScalingReport(std::ostream& out, const std::string& title, const std::vector<ScalingSample>& samples,
+    const std::string& countName = "nodes");
+
+  // Fresh parallel search for each run, so no run benefits from another's table.
+  ParallelSearcher parallelSearcher(ParallelSearchMode mode, size_t transpositionTableMegabytes = DEFAULT_TRANSPOSITION_TABLE_MEGABYTES);
+
+  // Measures and reports Lazy SMP and ABDADA on the benchmark positions with the same limits.
+  void compareParallelSearches(std::ostream& out, const std::vector<int>& threadCounts, const SearchLimits& limits);
+
+  // Shared tree MctsEngine and root parallel MctsEnsemble with the given arena size per tree.
+  MctsSearcher sharedTreeSearcher(size_t arenaMegabytes = DEFAULT_MCTS_ARENA_MEGABYTES);
+  MctsSearcher rootParallelSearcher(size_t arenaMegabytesPerTree = DEFAULT_MCTS_ARENA_MEGABYTES);
+
+  // Measures and reports both MCTS modes on the benchmark positions with the same limits.
+  void compareMctsModes(std::ostream& out, const std::vector<int>& threadCounts, const MctsLimits& limits);
+}
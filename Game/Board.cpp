@@ -1,15 +1,116 @@
 #include "pch.h"
 
+#include <algorithm>
+
 #include "Board.hpp"
+#include "BoardGeometry.hpp"
+#include "Pathing.hpp"
+#include "Symmetry.hpp"
+#include "Zobrist.hpp"
 
 using namespace std;
 using namespace Quoridor;
 
+static inline int8_t wallNumber(int8_t x, int8_t y) {
+  return x + y * WALL_CENTERS_PER_ROW;
+}
+
+static inline int8_t xCordinate(int8_t wallNumber) {
+  return wallNumber % WALL_CENTERS_PER_ROW;
+}
+
+static inline int8_t yCordinate(int8_t wallNumber) {
+  return wallNumber / WALL_CENTERS_PER_ROW;
+}
+
 Board::Board()
   : _playerOnePosition(BOARD_SIZE / 2, 0)
   , _playerTwoPosition(BOARD_SIZE / 2, BOARD_SIZE - 1)
+  , _currentPlayer(PLAYER_ONE)
+  , _zobristKey(computeZobristKey())
 { }
 
+static const int PACKED_ORIENTATION_BITS = 2 * STARTING_WALL_COUNTS;
+static const int PACKED_CELL_BITS = 7;
+static const int PACKED_PLAYER_ONE_CELL_SHIFT = PACKED_ORIENTATION_BITS;
+static const int PACKED_PLAYER_TWO_CELL_SHIFT = PACKED_PLAYER_ONE_CELL_SHIFT + PACKED_CELL_BITS;
+static const int PACKED_PLAYER_ONE_WALLS_SHIFT = PACKED_PLAYER_TWO_CELL_SHIFT + PACKED_CELL_BITS;
+static const int PACKED_PLAYER_TWO_WALLS_SHIFT = PACKED_PLAYER_ONE_WALLS_SHIFT + 4;
+static const int PACKED_CURRENT_PLAYER_SHIFT = PACKED_PLAYER_TWO_WALLS_SHIFT + 4;
+static const uint64_t PACKED_CELL_MASK = (1ULL << PACKED_CELL_BITS) - 1;
+static_assert(CELL_COUNT <= (1 << PACKED_CELL_BITS), "Squares no longer fit the packed encoding");
+static_assert(PACKED_CURRENT_PLAYER_SHIFT < 64, "Packed details no longer fit in one word");
+
+Board::Board(const PackedBoard& packed)
+  : _playerOnePosition(BoardGeometry::instance().point((packed.details >> PACKED_PLAYER_ONE_CELL_SHIFT) & PACKED_CELL_MASK))
+  , _playerTwoPosition(BoardGeometry::instance().point((packed.details >> PACKED_PLAYER_TWO_CELL_SHIFT) & PACKED_CELL_MASK))
+  , _playerWalls(
+      (packed.details >> PACKED_PLAYER_ONE_WALLS_SHIFT) & MASK_HALF_BYTE,
+      (packed.details >> PACKED_PLAYER_TWO_WALLS_SHIFT) & MASK_HALF_BYTE)
+  , _currentPlayer(static_cast<Player>((packed.details >> PACKED_CURRENT_PLAYER_SHIFT) & 1))
+{
+  const uint64_t vertical = Bits::deposit(packed.details, packed.occupiedCenters);
+  _wallsState = WallsState(packed.occupiedCenters & ~vertical, vertical);
+  _zobristKey = computeZobristKey();
+}
+
+static inline PackedBoard packState(uint64_t horizontal, uint64_t vertical, int playerOneCell, int playerTwoCell,
+                                    int playerOneWalls, int playerTwoWalls, Player currentPlayer) {
+  const uint64_t occupied = horizontal | vertical;
+  uint64_t details = Bits::extract(vertical, occupied);
+  details |= static_cast<uint64_t>(playerOneCell) << PACKED_PLAYER_ONE_CELL_SHIFT;
+  details |= static_cast<uint64_t>(playerTwoCell) << PACKED_PLAYER_TWO_CELL_SHIFT;
+  details |= static_cast<uint64_t>(playerOneWalls) << PACKED_PLAYER_ONE_WALLS_SHIFT;
+  details |= static_cast<uint64_t>(playerTwoWalls) << PACKED_PLAYER_TWO_WALLS_SHIFT;
+  details |= static_cast<uint64_t>(currentPlayer) << PACKED_CURRENT_PLAYER_SHIFT;
+  return{ occupied, details };
+}
+
+PackedBoard Board::pack() const {
+  return packState(_wallsState.horizontalWalls(), _wallsState.verticalWalls(),
+                   cellIndex(_playerOnePosition), cellIndex(_playerTwoPosition),
+                   _playerWalls.wallCountForPlayer(PLAYER_ONE), _playerWalls.wallCountForPlayer(PLAYER_TWO),
+                   _currentPlayer);
+}
+
+PackedBoard Board::pack(Symmetry symmetry) const {
+  const uint64_t horizontal = transformCenters(_wallsState.horizontalWalls(), symmetry);
+  const uint64_t vertical = transformCenters(_wallsState.verticalWalls(), symmetry);
+  const int playerOneCell = transformCell(cellIndex(_playerOnePosition), symmetry);
+  const int playerTwoCell = transformCell(cellIndex(_playerTwoPosition), symmetry);
+  const int playerOneWalls = _playerWalls.wallCountForPlayer(PLAYER_ONE);
+  const int playerTwoWalls = _playerWalls.wallCountForPlayer(PLAYER_TWO);
+  if (swapsPlayers(symmetry)) {
+    return packState(horizontal, vertical, playerTwoCell, playerOneCell, playerTwoWalls, playerOneWalls,
+                     opponentOf(_currentPlayer));
+  }
+  return packState(horizontal, vertical, playerOneCell, playerTwoCell, playerOneWalls, playerTwoWalls,
+                   _currentPlayer);
+}
+
+CanonicalBoard Board::canonical() const {
+  CanonicalBoard best = { pack(), IDENTITY };
+  for (int symmetry = MIRROR; symmetry < SYMMETRY_COUNT; ++symmetry) {
+    const PackedBoard candidate = pack(static_cast<Symmetry>(symmetry));
+    if (candidate < best.packed) {
+      best.packed = candidate;
+      best.symmetry = static_cast<Symmetry>(symmetry);
+    }
+  }
+  return best;
+}
+
+size_t PackedBoard::hash() const {
+  // murmur3 finalizer over both words, good enough to spread the mostly empty wall word.
+  uint64_t h = occupiedCenters ^ (details * 0x9E3779B97F4A7C15ULL);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return static_cast<size_t>(h);
+}
+
 Point Board::playerPosition(Player player) const {
   switch (player) {
   case PLAYER_ONE:
@@ -26,43 +127,221 @@ int Board::wallCount(Player player) const {
   return _playerWalls.wallCountForPlayer(player);
 }
 
-const vector<Move> Board::availableMoves(Player player) {
-  auto allMoves = availablePieceMovesForPlayer(player);
-  allMoves.reserve(132); // Maximum possible moves at any point
-  auto wallMoves = availableWallPlacementsForPlayer(player);
-  copy(begin(wallMoves), end(wallMoves), back_inserter(allMoves));
-  return allMoves;
+boost::optional<Player> Board::winner() const {
+  if (_playerOnePosition.y() == BOARD_SIZE - 1) {
+    return PLAYER_ONE;
+  }
+  if (_playerTwoPosition.y() == 0) {
+    return PLAYER_TWO;
+  }
+  return boost::none;
+}
+
+void Board::availableMoves(Player player, MoveList& moves) const {
+  moves.clear();
+  availablePieceMovesForPlayer(player, moves);
+  availableWallPlacementsForPlayer(player, moves);
+}
+
+static inline Point adjacentPoint(Point p, Direction direction) {
+  switch (direction) {
+  case UP:
+    return{ p.x(), static_cast<int8_t>(p.y() - 1) };
+  case DOWN:
+    return{ p.x(), static_cast<int8_t>(p.y() + 1) };
+  case LEFT:
+    return{ static_cast<int8_t>(p.x() - 1), p.y() };
+  case RIGHT:
+    return{ static_cast<int8_t>(p.x() + 1), p.y() };
+  default:
+    ARC_FAIL("Invalid direction!");
+    return p;
+  }
+}
+
+uint64_t Board::computeZobristKey() const {
+  const ZobristKeys& keys = ZobristKeys::instance();
+  uint64_t key = keys.pawn(PLAYER_ONE, cellIndex(_playerOnePosition))
+    ^ keys.pawn(PLAYER_TWO, cellIndex(_playerTwoPosition))
+    ^ keys.wallCount(PLAYER_ONE, _playerWalls.wallCountForPlayer(PLAYER_ONE))
+    ^ keys.wallCount(PLAYER_TWO, _playerWalls.wallCountForPlayer(PLAYER_TWO));
+  uint64_t horizontal = _wallsState.horizontalWalls();
+  while (horizontal != 0) {
+    key ^= keys.wall(PLACE_HORIZONAL_WALL, Bits::popLowestBit(horizontal));
+  }
+  uint64_t vertical = _wallsState.verticalWalls();
+  while (vertical != 0) {
+    key ^= keys.wall(PLACE_VERTICAL_WALL, Bits::popLowestBit(vertical));
+  }
+  if (_currentPlayer == PLAYER_TWO) {
+    key ^= keys.playerTwoToMove();
+  }
+  return key;
+}
+
+MoveUndo Board::doMove(const Move& move) {
+  ARC_ASSERT(move.player == _currentPlayer);
+  const ZobristKeys& keys = ZobristKeys::instance();
+  Point& position = playerPositionRef(move.player);
+  const MoveUndo undo = { move, position };
+  switch (move.type) {
+  case MOVE_PIECE:
+    _zobristKey ^= keys.pawn(move.player, cellIndex(position));
+    position = adjacentPoint(position, move.info.pieceMoveDirection);
+    _zobristKey ^= keys.pawn(move.player, cellIndex(position));
+    break;
+  case JUMP_PIECE:
+    _zobristKey ^= keys.pawn(move.player, cellIndex(position));
+    position = move.info.jumpDestination;
+    _zobristKey ^= keys.pawn(move.player, cellIndex(position));
+    break;
+  case PLACE_HORIZONAL_WALL:
+  case PLACE_VERTICAL_WALL:
+  {
+    const int wallCount = _playerWalls.wallCountForPlayer(move.player);
+    _zobristKey ^= keys.wall(move.type, wallNumber(move.info.wallCenter.x(), move.info.wallCenter.y()))
+      ^ keys.wallCount(move.player, wallCount)
+      ^ keys.wallCount(move.player, wallCount - 1);
+    _wallsState.placeWall(move.info.wallCenter.x(), move.info.wallCenter.y(), move.type);
+    _playerWalls.decrementWallCountForPlayer(move.player);
+    if (_goalDistances) {
+      _goalDistances->wallPlaced(_wallsState, move.info.wallCenter.x(), move.info.wallCenter.y(), move.type);
+    }
+    break;
+  }
+  }
+  _zobristKey ^= keys.playerTwoToMove();
+  _currentPlayer = opponentOf(move.player);
+  return undo;
+}
+
+void Board::undoMove(const MoveUndo& undo) {
+  const Move& move = undo.move;
+  ARC_ASSERT(move.player == opponentOf(_currentPlayer));
+  const ZobristKeys& keys = ZobristKeys::instance();
+  if (move.type == PLACE_HORIZONAL_WALL || move.type == PLACE_VERTICAL_WALL) {
+    const int wallCount = _playerWalls.wallCountForPlayer(move.player);
+    _zobristKey ^= keys.wall(move.type, wallNumber(move.info.wallCenter.x(), move.info.wallCenter.y()))
+      ^ keys.wallCount(move.player, wallCount)
+      ^ keys.wallCount(move.player, wallCount + 1);
+    _wallsState.removeWall(move.info.wallCenter.x(), move.info.wallCenter.y(), move.type);
+    _playerWalls.incrementWallCountForPlayer(move.player);
+    if (_goalDistances) {
+      _goalDistances->wallRemoved();
+    }
+  }
+  else {
+    Point& position = playerPositionRef(move.player);
+    _zobristKey ^= keys.pawn(move.player, cellIndex(position)) ^ keys.pawn(move.player, cellIndex(undo.previousPosition));
+    position = undo.previousPosition;
+  }
+  _zobristKey ^= keys.playerTwoToMove();
+  _currentPlayer = move.player;
+}
+
+void Board::enableGoalDistances() {
+  if (!_goalDistances) {
+    _goalDistances = GoalDistances(_wallsState);
+  }
 }
 
-void Board::doMove(const Move& move) {
+int Board::goalDistance(Player player) const {
+  ARC_ASSERT(hasGoalDistances());
+  return _goalDistances->distance(player, cellIndex(playerPosition(player)));
+}
 
+void Board::availablePieceMovesForPlayer(Player player, MoveList& moves) const {
+  _wallsState.availablePieceMoves(player, cellIndex(playerPosition(player)),
+    cellIndex(playerPosition(opponentOf(player))), moves);
 }
 
-vector<Move> Board::availablePieceMovesForPlayer(Player player) {
-  vector<Move> moves;
-  moves.reserve(5); // max possible moves from any given position.
-  // TODO::JT logic does not yet account for collisions or jumping rules.
-  const Point playerPosition = player == PLAYER_ONE ? _playerOnePosition : _playerTwoPosition;
+void Board::availableWallPlacementsForPlayer(Player player, MoveList& moves, WallSelection selection) const {
+  if (_playerWalls.wallCountForPlayer(player) == 0) {
+    return;
+  }
+  uint64_t vertical = _wallsState.availableVerticalCenters();
+  uint64_t horizontal = _wallsState.availableHorizontalCenters();
+  if (selection != ALL_WALLS) {
+    const int cell = cellIndex(playerPosition(player));
+    const int opponentCell = cellIndex(playerPosition(opponentOf(player)));
+    const PromisingWalls promising = _goalDistances
+      ? promisingWalls(_wallsState, *_goalDistances, player, cell, opponentCell)
+      : promisingWalls(_wallsState, GoalDistances(_wallsState), player, cell, opponentCell);
+    if (selection == PROMISING_WALLS) {
+      vertical &= promising.vertical;
+      horizontal &= promising.horizontal;
+    }
+    else {
+      vertical &= ~promising.vertical;
+      horizontal &= ~promising.horizontal;
+    }
+  }
 
-  // check board bounds
-  if (playerPosition.x() != 0) {
-    moves.push_back({ player, LEFT });
+  // A wall is only legal if both players can still reach their goal row afterwards. The cut filter
+  // clears most candidates outright, the rest get a flood fill. The movement masks for the current
+  // walls are built once and each candidate only adds its own two edges.
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  const MovementMasks current(_wallsState);
+  WallCutFilter filter(_wallsState);
+  const int playerOneCell = cellIndex(_playerOnePosition);
+  const int playerTwoCell = cellIndex(_playerTwoPosition);
+  if (_goalDistances) {
+    filter.addRoute(_wallsState, *_goalDistances, PLAYER_ONE, playerOneCell);
+    filter.addRoute(_wallsState, *_goalDistances, PLAYER_TWO, playerTwoCell);
   }
-  if (playerPosition.x() != BOARD_SIZE - 1) {
-    moves.push_back({ player, RIGHT });
+  else {
+    filter.addRoute(current, _wallsState, playerOneCell, geometry.goalCells(PLAYER_ONE));
+    filter.addRoute(current, _wallsState, playerTwoCell, geometry.goalCells(PLAYER_TWO));
   }
-  if (playerPosition.y() != 0) {
-    moves.push_back({ player, UP });
+
+  while (vertical != 0) {
+    const int8_t pointNumber = Bits::popLowestBit(vertical);
+    if (!filter.mayDisconnect(pointNumber, PLACE_VERTICAL_WALL)
+        || wallKeepsPathsOpen(current, pointNumber, PLACE_VERTICAL_WALL)) {
+      moves.push_back({ player, PLACE_VERTICAL_WALL, { xCordinate(pointNumber), yCordinate(pointNumber) } });
+    }
   }
-  if (playerPosition.y() != BOARD_SIZE - 1) {
-    moves.push_back({ player, DOWN });
+  while (horizontal != 0) {
+    const int8_t pointNumber = Bits::popLowestBit(horizontal);
+    if (!filter.mayDisconnect(pointNumber, PLACE_HORIZONAL_WALL)
+        || wallKeepsPathsOpen(current, pointNumber, PLACE_HORIZONAL_WALL)) {
+      moves.push_back({ player, PLACE_HORIZONAL_WALL, { xCordinate(pointNumber), yCordinate(pointNumber) } });
+    }
   }
-  return moves;
 }
 
-vector<Move> Board::availableWallPlacementsForPlayer(Player player) {
-  // TODO::JT logic does not account for pathing errors caused by bad walls.
-  return _wallsState.availableWallPlacements(player);
+bool Board::isLegal(const Move& move) const {
+  if (move.player != _currentPlayer || winner()) {
+    return false;
+  }
+  if (move.type == MOVE_PIECE || move.type == JUMP_PIECE) {
+    MoveList pieceMoves;
+    availablePieceMovesForPlayer(move.player, pieceMoves);
+    return find(begin(pieceMoves), end(pieceMoves), move) != end(pieceMoves);
+  }
+  if (_playerWalls.wallCountForPlayer(move.player) == 0) {
+    return false;
+  }
+  const Point center = move.info.wallCenter;
+  if (center.x() >= WALL_CENTERS_PER_ROW || center.y() >= WALL_CENTERS_PER_ROW) {
+    return false;
+  }
+  const int pointNumber = wallNumber(center.x(), center.y());
+  const uint64_t available = move.type == PLACE_VERTICAL_WALL
+    ? _wallsState.availableVerticalCenters()
+    : _wallsState.availableHorizontalCenters();
+  if ((available & (1ULL << pointNumber)) == 0) {
+    return false;
+  }
+  return wallKeepsPathsOpen(MovementMasks(_wallsState), pointNumber, move.type);
+}
+
+bool Board::wallKeepsPathsOpen(const MovementMasks& current, int center, MoveType type) const {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  MovementMasks withWall = current;
+  withWall.addWall(center, type);
+  return withWall.canReach(cellIndex(_playerOnePosition), geometry.goalCells(PLAYER_ONE))
+      && withWall.canReach(cellIndex(_playerTwoPosition), geometry.goalCells(PLAYER_TWO));
 }
 
 vector<Wall> Board::walls() const {
@@ -127,82 +406,84 @@ bool Move::operator<(const Move& other) const {
 // Wall State
 //////////////////////////////////////////////////////////////////////////
 
-WallsState::WallsState() {
-  fill(begin(_state), end(_state), 0);
+WallsState::WallsState()
+  : _horizontal(0)
+  , _vertical(0)
+{ }
+
+WallsState::WallsState(uint64_t horizontal, uint64_t vertical)
+  : _horizontal(horizontal)
+  , _vertical(vertical)
+{ }
+
+void WallsState::placeWall(int8_t centerX, int8_t centerY, MoveType type) {
+  // Note: do not bother with validation. This is a dumb function that just assumes
+  // the inputs are reasonable.
+  const uint64_t bit = 1ULL << wallNumber(centerX, centerY);
+  if (type == PLACE_VERTICAL_WALL) {
+    _vertical |= bit;
+  }
+  else {
+    _horizontal |= bit;
+  }
 }
 
-static inline int8_t wallNumber(int8_t x, int8_t y) {
-  return x + y * (BOARD_SIZE - 1);
+// The rules themselves are shared with VariantBoard, so both play exactly the same game.
+typedef VariantRules<BOARD_SIZE> StandardRules;
+
+uint8_t WallsState::openDirections(int cell) const {
+  return StandardRules::openDirections(cell, _horizontal, _vertical);
 }
 
-static inline int8_t xCordinate(int8_t wallNumber) {
-  return wallNumber % (BOARD_SIZE - 1);
+void WallsState::availablePieceMoves(Player player, int cell, int opponentCell, MoveList& moves) const {
+  StandardRules::availablePieceMoves(player, cell, opponentCell, _horizontal, _vertical, moves);
 }
 
-static inline int8_t yCordinate(int8_t wallNumber) {
-  return wallNumber / (BOARD_SIZE - 1);
+void WallsState::removeWall(int8_t centerX, int8_t centerY, MoveType type) {
+  const uint64_t clearMask = ~(1ULL << wallNumber(centerX, centerY));
+  if (type == PLACE_VERTICAL_WALL) {
+    _vertical &= clearMask;
+  }
+  else {
+    _horizontal &= clearMask;
+  }
 }
 
-static const int8_t NO_WALL = 0x00;
-static const int8_t HORIZONTAL_WALL = PLACE_HORIZONAL_WALL;
-static const int8_t VERTICAL_WALL = PLACE_VERTICAL_WALL;
-void WallsState::placeWall(int8_t centerX, int8_t centerY, MoveType type) {
-  // Note: do not bother with validation. This is a dumb function that just assumes
-  // the inputs are reasonable.
-  const int8_t pointNumber = wallNumber(centerX, centerY);
-  const int8_t byteNumber = wallByteOffset(pointNumber);
-  const int8_t bitOffset = wallBitOffset(pointNumber);
-  const int8_t clearMask = ~(TWO_BIT_MASK << bitOffset);
-  const int8_t newValue = type << bitOffset;
-  auto targetByte = _state.begin() + byteNumber;
-  *targetByte = (*targetByte & clearMask) | newValue;
+uint64_t WallsState::availableHorizontalCenters() const {
+  return StandardRules::availableHorizontalCenters(_horizontal, _vertical);
+}
+
+uint64_t WallsState::availableVerticalCenters() const {
+  return StandardRules::availableVerticalCenters(_horizontal, _vertical);
 }
 
 std::vector<Wall> WallsState::walls() const {
   std::vector<Wall> walls;
-  const int totalCenterPoints = (BOARD_SIZE - 1) * (BOARD_SIZE - 1);
-  for (int pointNumber = 0; pointNumber < totalCenterPoints; ++pointNumber) {
-    const int8_t value = wallValue(pointNumber);
-    const int xCord = xCordinate(pointNumber);
-    const int yCord = yCordinate(pointNumber);
-    if (value == VERTICAL_WALL) {
-      walls.push_back({ xCord, yCord, true });
-    }
-    else if (value == HORIZONTAL_WALL) {
-      walls.push_back({ xCord, yCord, false });
-    }
+  walls.reserve(wallCount());
+  uint64_t horizontal = _horizontal;
+  while (horizontal != 0) {
+    const int8_t pointNumber = Bits::popLowestBit(horizontal);
+    walls.push_back({ xCordinate(pointNumber), yCordinate(pointNumber), false });
+  }
+  uint64_t vertical = _vertical;
+  while (vertical != 0) {
+    const int8_t pointNumber = Bits::popLowestBit(vertical);
+    walls.push_back({ xCordinate(pointNumber), yCordinate(pointNumber), true });
   }
   return walls;
 }
 
-vector<Move> WallsState::availableWallPlacements(Player player) const {
-  vector<Move> moves;
-  moves.reserve(128); // max number of possible wall placements.
-  const int totalCenterPoints = (BOARD_SIZE - 1) * (BOARD_SIZE - 1);
-  for (int pointNumber = 0; pointNumber < totalCenterPoints; ++pointNumber) {
-    const int8_t value = wallValue(pointNumber);
-    if (value == NO_WALL) {
-      const int8_t x = pointNumber % (BOARD_SIZE - 1);
-      const int8_t y = pointNumber / (BOARD_SIZE - 1);
-
-      // if vertical there can't be a wall above or below.
-      // if horizontal there can't be a wall left or right.
-      auto upWallNumber = wallNumber(x, y - 1);
-      auto downWallNumber = wallNumber(x, y + 1);
-      auto leftWallNumber = wallNumber(x - 1, y);
-      auto rightWallNumber = wallNumber(x + 1, y);
-
-      // check if a vertical wall is valid here
-      if (wallValue(upWallNumber) != VERTICAL_WALL && wallValue(downWallNumber) != VERTICAL_WALL) {
-        moves.push_back({ player, PLACE_VERTICAL_WALL, {x, y} });
-      }
-      // next up is if a horizontal wall is valid here
-      if (wallValue(leftWallNumber) != HORIZONTAL_WALL && wallValue(rightWallNumber) != HORIZONTAL_WALL) {
-        moves.push_back({ player, PLACE_HORIZONAL_WALL,{ x, y } });
-      }
-    }
+void WallsState::availableWallPlacements(Player player, MoveList& moves) const {
+  uint64_t horizontal = availableHorizontalCenters();
+  uint64_t vertical = availableVerticalCenters();
+  while (vertical != 0) {
+    const int8_t pointNumber = Bits::popLowestBit(vertical);
+    moves.push_back({ player, PLACE_VERTICAL_WALL, { xCordinate(pointNumber), yCordinate(pointNumber) } });
+  }
+  while (horizontal != 0) {
+    const int8_t pointNumber = Bits::popLowestBit(horizontal);
+    moves.push_back({ player, PLACE_HORIZONAL_WALL, { xCordinate(pointNumber), yCordinate(pointNumber) } });
   }
-  return moves;
 }
 
 bool Quoridor::Wall::operator==(const Wall& other) const {
@@ -1,13 +1,26 @@
+#pragma once
+
 #include <boost/optional/optional.hpp>
 #include <array>
+#include <functional>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 #include "Util/Arc_Assert.hpp"
+#include "Util/Bits.hpp"
+#include "Variant.hpp"
 
 namespace Quoridor {
 
-  const int BOARD_SIZE = 9;
-  const int BOARD_BYTES = (BOARD_SIZE * (BOARD_SIZE - 1) * 2 + 8 * 8) / 8;
+  class MovementMasks;
+
+  // Board and the modules built on it play the standard game. Other variants use VariantBoard.
+  const int BOARD_SIZE = StandardVariant::BOARD_SIZE;
+  const int WALL_CENTERS_PER_ROW = BOARD_SIZE - 1;
+  const int WALL_CENTER_COUNT = WALL_CENTERS_PER_ROW * WALL_CENTERS_PER_ROW;
+  // Squares are numbered x + y * BOARD_SIZE.
+  const int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
 
   enum Direction : int8_t {
     UP,
@@ -15,6 +28,7 @@ namespace Quoridor {
     LEFT,
     RIGHT
   };
+  const int DIRECTION_COUNT = 4;
 
   enum WallOrientation : int8_t {
     HORIZONTAL,
@@ -26,6 +40,10 @@ namespace Quoridor {
     PLAYER_TWO = 1
   };
 
+  inline Player opponentOf(Player player) {
+    return static_cast<Player>(player ^ 1);
+  }
+
   const int8_t MASK_HALF_BYTE = 0x0F;
   // Point class that supports only the range needed for the game. Ie. [0,9) x [0,9)
   // first 4 bits are X, next 4 bits are Y.
@@ -52,13 +70,16 @@ namespace Quoridor {
     int8_t pos;
   };
 
-  const int8_t STARTING_WALL_COUNTS = 10;
+  const int8_t STARTING_WALL_COUNTS = StandardVariant::STARTING_WALL_COUNTS;
   // Like the point class this only  supports the range of walls needed for the game. Ie. [0,10) x [0,10)
   // first 4 bits are p1 walls, next 4 bits are p2 walls.
   class WallCounts {
   public:
     WallCounts()
-      : _counts((STARTING_WALL_COUNTS & MASK_HALF_BYTE) | ((STARTING_WALL_COUNTS & MASK_HALF_BYTE) << 4))
+      : WallCounts(STARTING_WALL_COUNTS, STARTING_WALL_COUNTS)
+    {}
+    WallCounts(int8_t playerOneWalls, int8_t playerTwoWalls)
+      : _counts((playerOneWalls & MASK_HALF_BYTE) | ((playerTwoWalls & MASK_HALF_BYTE) << 4))
     {}
 
     inline int8_t wallCountForPlayer(Player player) const {
@@ -72,10 +93,30 @@ namespace Quoridor {
       const int8_t CLEAR_MASK = ~(MASK_HALF_BYTE << (4 * player));
       _counts = (_counts & CLEAR_MASK) | wallCount;
     }
+    inline void incrementWallCountForPlayer(Player player) {
+      ARC_ASSERT(wallCountForPlayer(player) < STARTING_WALL_COUNTS);
+      _counts += 1 << (4 * player);
+    }
   private:
     int8_t _counts;
   };
 
+  // Transformations that map a position onto an equivalent one. Each is its own inverse.
+  enum Symmetry : int8_t {
+    IDENTITY = 0,
+    // Left to right mirror image.
+    MIRROR = 1,
+    // Rotated half a turn with the two players swapped.
+    ROTATE_SWAP = 2,
+    // Flipped top to bottom with the two players swapped, ie. both of the above.
+    FLIP_SWAP = 3
+  };
+  const int SYMMETRY_COUNT = 4;
+
+  inline bool swapsPlayers(Symmetry symmetry) {
+    return symmetry >= ROTATE_SWAP;
+  }
+
   enum MoveType : int8_t {
     MOVE_PIECE = 0,
     PLACE_HORIZONAL_WALL = 1,
@@ -83,12 +124,15 @@ namespace Quoridor {
     JUMP_PIECE = 3
   };
 
+  // Piece moves store the direction stepped in. Wall placements store the wall center and jumps
+  // store the square the piece lands on.
   union MoveInfo {
     MoveInfo(Direction);
     MoveInfo(Point);
 
     Direction pieceMoveDirection;
     Point wallCenter;
+    Point jumpDestination;
   };
 
   class Move {
@@ -104,6 +148,66 @@ namespace Quoridor {
     MoveInfo info;
   };
 
+  const int MAX_PIECE_MOVES = 5;
+  const int MAX_WALL_MOVES = 2 * WALL_CENTER_COUNT;
+  const int MAX_MOVES = MAX_PIECE_MOVES + MAX_WALL_MOVES;
+
+  // Fixed capacity list of moves that lives wherever it is declared, typically the stack of a search
+  // node. Move generation appends to one of these in place so generating moves never touches the heap.
+  template <int CAPACITY>
+  class FixedMoveList {
+  public:
+    FixedMoveList()
+      : _size(0)
+    {}
+
+    inline void push_back(const Move& move) {
+      ARC_ASSERT(_size < CAPACITY);
+      new (&_storage[_size]) Move(move);
+      ++_size;
+    }
+    inline void clear() {
+      _size = 0;
+    }
+
+    inline int size() const {
+      return _size;
+    }
+    inline bool empty() const {
+      return _size == 0;
+    }
+    static inline int capacity() {
+      return CAPACITY;
+    }
+
+    inline Move* begin() {
+      return reinterpret_cast<Move*>(_storage);
+    }
+    inline Move* end() {
+      return begin() + _size;
+    }
+    inline const Move* begin() const {
+      return reinterpret_cast<const Move*>(_storage);
+    }
+    inline const Move* end() const {
+      return begin() + _size;
+    }
+
+    inline Move& operator[](int index) {
+      ARC_ASSERT(index >= 0 && index < _size);
+      return begin()[index];
+    }
+    inline const Move& operator[](int index) const {
+      ARC_ASSERT(index >= 0 && index < _size);
+      return begin()[index];
+    }
+  private:
+    typename std::aligned_storage<sizeof(Move), alignof(Move)>::type _storage[CAPACITY];
+    int _size;
+  };
+
+  typedef FixedMoveList<MAX_MOVES> MoveList;
+
   class Wall {
   public:
     int centerX;
@@ -114,60 +218,200 @@ namespace Quoridor {
     bool operator<(const Wall& other) const;
   };
 
-  const int8_t INVALID_WALL_NUMBER = -1;
-  const int8_t INVALID_WALL_VALUE = -2;
-  const int8_t TWO_BIT_MASK = 0x03;
+  // Wall centers are stored as bitboards, one bit per center with bit number x + y * WALL_CENTERS_PER_ROW.
+  // A center may hold at most one wall and horizontal and vertical walls are kept in separate masks.
   class WallsState {
   public:
     WallsState();
+    WallsState(uint64_t horizontal, uint64_t vertical);
 
-    // Provides a list of all moves where walls could be placed without collision.
-    std::vector<Move> availableWallPlacements(Player player) const;
+    // Appends all moves where walls could be placed without collision.
+    void availableWallPlacements(Player player, MoveList& moves) const;
 
     void placeWall(int8_t centerX, int8_t centerY, MoveType type);
+    void removeWall(int8_t centerX, int8_t centerY, MoveType type);
     std::vector<Wall> walls() const;
-  private:
 
-    inline int8_t wallByteOffset(int8_t pointNumber) const {
-      return pointNumber / 4;
+    inline uint64_t horizontalWalls() const {
+      return _horizontal;
+    }
+    inline uint64_t verticalWalls() const {
+      return _vertical;
     }
+    inline int wallCount() const {
+      return Bits::popCount(_horizontal | _vertical);
+    }
+
+    // Bit set of the directions a piece on the given square can step in without leaving the board
+    // or crossing a wall.
+    uint8_t openDirections(int cell) const;
+    // Appends the steps and jumps of a pawn on the given square with the other pawn on opponentCell.
+    void availablePieceMoves(Player player, int cell, int opponentCell, MoveList& moves) const;
 
-    inline int8_t wallBitOffset(int8_t pointNumber) const {
-      return (pointNumber % 4) * 2;
+    // Masks of the centers where a wall of the given orientation would not collide with an existing wall.
+    uint64_t availableHorizontalCenters() const;
+    uint64_t availableVerticalCenters() const;
+  private:
+    uint64_t _horizontal;
+    uint64_t _vertical;
+  };
+  
+  // Distance from every square to each player's goal row, ignoring pawns. Built with a full search
+  // once and then kept up to date as walls go down: a wall can only ever make distances longer, so
+  // only squares that lost their last shortest route get recomputed. The old values are logged so
+  // taking the wall back just replays the log.
+  class GoalDistances {
+  public:
+    static const uint8_t UNREACHABLE = 0xFF;
+
+    explicit GoalDistances(const WallsState& walls);
+
+    inline int distance(Player player, int cell) const {
+      return _distances[player][cell];
     }
 
-    inline int8_t wallValue(int8_t wallNumber) const {
-      const int8_t byteNumber = wallByteOffset(wallNumber);
-      const int8_t bitOffset = wallBitOffset(wallNumber);
-      if (byteNumber < 0 || byteNumber > _state.size()) {
-        return INVALID_WALL_VALUE;
-      }
-      return (_state[byteNumber] >> bitOffset) & TWO_BIT_MASK;
+    // Must be called with the walls after the new wall has been placed.
+    void wallPlaced(const WallsState& walls, int8_t centerX, int8_t centerY, MoveType type);
+    // Reverts the most recent wallPlaced.
+    void wallRemoved();
+  private:
+    struct Change {
+      Player player;
+      uint8_t cell;
+      uint8_t distance;
+    };
+
+    void recompute(Player player, const WallsState& walls);
+    void update(Player player, const WallsState& walls, const int (&cutEdges)[2][2]);
+
+    uint8_t _distances[2][CELL_COUNT];
+    std::vector<Change> _changes;
+    std::vector<uint16_t> _wallMarks;
+  };
+
+  // Subsets of the wall placements, see promisingWalls in Pathing.hpp.
+  enum WallSelection {
+    ALL_WALLS,
+    PROMISING_WALLS,
+    UNPROMISING_WALLS
+  };
+
+  // Everything needed to take back a move made with Board::doMove.
+  struct MoveUndo {
+    Move move;
+    Point previousPosition;
+  };
+
+  // The full game state in 16 bytes, usable as a hash key or an on disk record. Every position has
+  // exactly one encoding.
+  //
+  // The first word is the set of occupied wall centers. The second word holds, from the low bit up:
+  // one orientation bit per occupied center in center order (set for vertical, at most 20 bits), then
+  // 7 bits each for the two pawn squares, 4 bits each for the two wall counts and the side to move.
+  struct PackedBoard {
+    uint64_t occupiedCenters;
+    uint64_t details;
+
+    inline bool operator==(const PackedBoard& other) const {
+      return occupiedCenters == other.occupiedCenters && details == other.details;
+    }
+    inline bool operator!=(const PackedBoard& other) const {
+      return !(*this == other);
+    }
+    inline bool operator<(const PackedBoard& other) const {
+      return occupiedCenters != other.occupiedCenters ? occupiedCenters < other.occupiedCenters : details < other.details;
     }
 
-    std::array<int8_t, BOARD_BYTES> _state;
+    size_t hash() const;
   };
-  
+  static_assert(sizeof(PackedBoard) == 16, "PackedBoard must stay two words");
+
+  // The representative of a position's symmetry class, and the symmetry that takes the position there.
+  // Moves found for the representative map back with transformMove and the same symmetry.
+  struct CanonicalBoard {
+    PackedBoard packed;
+    Symmetry symmetry;
+  };
+
   class Board final {
   public:
     Board();
+    explicit Board(const PackedBoard& packed);
+
+    PackedBoard pack() const;
+    // Packs the position as it looks after applying the symmetry.
+    PackedBoard pack(Symmetry symmetry) const;
+    // Smallest packed encoding over all symmetric versions of the position, so equivalent positions
+    // share one key.
+    CanonicalBoard canonical() const;
 
     // For visualization
     Point playerPosition(Player player) const;
     int wallCount(Player player) const;
     std::vector<Wall> walls() const;
+    inline Player currentPlayer() const {
+      return _currentPlayer;
+    }
+    // Zobrist key of the position, kept up to date by doMove and undoMove.
+    inline uint64_t zobristKey() const {
+      return _zobristKey;
+    }
+    inline const WallsState& wallsState() const {
+      return _wallsState;
+    }
+    // The player who has reached their goal row, if either has.
+    boost::optional<Player> winner() const;
 
     // For changing state
-    const std::vector<Move> availableMoves(Player player);
-    void doMove(const Move& move);
+    // Fills the list with every move available to the player, piece moves first.
+    void availableMoves(Player player, MoveList& moves) const;
+    // The two halves of availableMoves, for generating moves in stages. Wall placements can further
+    // be split into the promising ones and the rest.
+    void availablePieceMovesForPlayer(Player player, MoveList& moves) const;
+    void availableWallPlacementsForPlayer(Player player, MoveList& moves, WallSelection selection = ALL_WALLS) const;
+    // Whether the move is one availableMoves would produce for the player to move. Cheaper than
+    // generating every move when checking a single one.
+    bool isLegal(const Move& move) const;
+    // Plays a move for the player whose turn it is. The returned record undoes it.
+    MoveUndo doMove(const Move& move);
+    // Takes back the most recent move. Moves must be undone in the reverse order they were made.
+    void undoMove(const MoveUndo& undo);
+
+    // Goal distances are optional since they cost a little on every wall placement. Once enabled
+    // they are kept up to date by doMove and undoMove.
+    void enableGoalDistances();
+    inline bool hasGoalDistances() const {
+      return _goalDistances.is_initialized();
+    }
+    inline const GoalDistances& goalDistances() const {
+      ARC_ASSERT(hasGoalDistances());
+      return *_goalDistances;
+    }
+    // Shortest number of steps from the player's pawn to their goal row, ignoring the other pawn.
+    int goalDistance(Player player) const;
   private:
-    std::vector<Move> availablePieceMovesForPlayer(Player player);
-    std::vector<Move> availableWallPlacementsForPlayer(Player player);
+    bool wallKeepsPathsOpen(const MovementMasks& current, int center, MoveType type) const;
 
+    inline Point& playerPositionRef(Player player) {
+      return player == PLAYER_ONE ? _playerOnePosition : _playerTwoPosition;
+    }
+    uint64_t computeZobristKey() const;
 
     Point _playerOnePosition;
     Point _playerTwoPosition;
     WallCounts _playerWalls;
+    Player _currentPlayer;
     WallsState _wallsState;
+    uint64_t _zobristKey;
+    boost::optional<GoalDistances> _goalDistances;
+  };
+}
+
+namespace std {
+  template <>
+  struct hash<Quoridor::PackedBoard> {
+    size_t operator()(const Quoridor::PackedBoard& packed) const {
+      return packed.hash();
+    }
   };
-}
\ No newline at end of file
+}
@@ -0,0 +1,11 @@
+#include "pch.h"
+
+#include "BoardGeometry.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+const BoardGeometry& BoardGeometry::instance() {
+  static const BoardGeometry geometry;
+  return geometry;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Board.hpp"
+#include "CellMask.hpp"
+#include "VariantGeometry.hpp"
+
+namespace Quoridor {
+
+  const int8_t NO_CELL = VariantTables::NO_CELL;
+  // Corners of squares, where wall ends meet, are numbered x + y * CORNERS_PER_ROW. Wall center (x, y)
+  // is corner (x + 1, y + 1).
+  const int CORNERS_PER_ROW = BOARD_SIZE + 1;
+
+  inline int cellIndex(int x, int y) {
+    return x + y * BOARD_SIZE;
+  }
+  inline int cellIndex(Point p) {
+    return cellIndex(p.x(), p.y());
+  }
+
+  inline uint8_t directionBit(int direction) {
+    return static_cast<uint8_t>(1 << direction);
+  }
+
+  // Lookup tables describing the layout of the board, so move generation only ever does table reads.
+  // These are the 9x9 VariantGeometry and VariantCells, built by the compiler and shared with
+  // VariantBoard.
+  class BoardGeometry final {
+  public:
+    static const BoardGeometry& instance();
+
+    // Square one step in the given direction, or NO_CELL when that would leave the board.
+    inline int8_t neighbour(int cell, int direction) const {
+      return Geometry::neighbour(cell, direction);
+    }
+    // Bit set of the directions that stay on the board from this square.
+    inline uint8_t onBoardDirections(int cell) const {
+      return Geometry::onBoardDirections(cell);
+    }
+    // Wall centers that block stepping from the square in the given direction. Up and down are only
+    // ever blocked by horizontal walls and left and right only by vertical walls.
+    inline uint64_t edgeBlockers(int cell, int direction) const {
+      return Geometry::edgeBlockers(cell, direction);
+    }
+    // The two directions at right angles to the given one, used for diagonal jumps.
+    inline int perpendicular(int direction, int which) const {
+      return Geometry::perpendicular(direction, which);
+    }
+    inline Point point(int cell) const {
+      return Geometry::point(cell);
+    }
+
+    inline const CellMask& allCells() const {
+      return Cells::allCells();
+    }
+    inline const CellMask& rowCells(int y) const {
+      return Cells::rowCells(y);
+    }
+    // The row a player has to reach to win.
+    inline const CellMask& goalCells(Player player) const {
+      return Cells::goalCells(player);
+    }
+    // Squares from which a step in the direction stays on the board.
+    inline const CellMask& onBoardCells(int direction) const {
+      return Cells::onBoardCells(direction);
+    }
+    // The two squares whose bottom edge a horizontal wall on this center covers, ie. (x, y) and (x + 1, y).
+    inline const CellMask& horizontalWallCells(int center) const {
+      return Cells::horizontalWallCells(center);
+    }
+    // The two squares whose right edge a vertical wall on this center covers, ie. (x, y) and (x, y + 1).
+    inline const CellMask& verticalWallCells(int center) const {
+      return Cells::verticalWallCells(center);
+    }
+    // Corners on the edge of the board.
+    inline const CellMask& borderCorners() const {
+      return Cells::borderCorners();
+    }
+    // The three corners a wall on this center runs through.
+    inline const CellMask& horizontalWallCorners(int center) const {
+      return Cells::horizontalWallCorners(center);
+    }
+    inline const CellMask& verticalWallCorners(int center) const {
+      return Cells::verticalWallCorners(center);
+    }
+  private:
+    BoardGeometry() { }
+    BoardGeometry(const BoardGeometry&) = delete;
+    BoardGeometry& operator=(const BoardGeometry&) = delete;
+
+    typedef VariantGeometry<BOARD_SIZE> Geometry;
+    typedef VariantCells<BOARD_SIZE> Cells;
+  };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Util/Arc_Assert.hpp"
+#include "Util/Bits.hpp"
+
+namespace Quoridor {
+
+  // 128 bit set of squares, one bit per square using the cell numbering from BoardGeometry.
+  // Only the low CELL_COUNT bits are meaningful, complements should be masked with the full board.
+  class CellMask {
+  public:
+    constexpr CellMask()
+      : _low(0)
+      , _high(0)
+    {}
+    constexpr CellMask(uint64_t low, uint64_t high)
+      : _low(low)
+      , _high(high)
+    {}
+
+    static inline CellMask cell(int index) {
+      return index < 64 ? CellMask(1ULL << index, 0) : CellMask(0, 1ULL << (index - 64));
+    }
+
+    inline bool test(int index) const {
+      return index < 64 ? ((_low >> index) & 1) != 0 : ((_high >> (index - 64)) & 1) != 0;
+    }
+    inline void set(int index) {
+      *this |= cell(index);
+    }
+    inline bool empty() const {
+      return (_low | _high) == 0;
+    }
+    inline bool any() const {
+      return !empty();
+    }
+    inline int count() const {
+      return Bits::popCount(_low) + Bits::popCount(_high);
+    }
+    // Clears the lowest square in the set and returns it. The set must not be empty.
+    inline int popLowestCell() {
+      if (_low != 0) {
+        return Bits::popLowestBit(_low);
+      }
+      return 64 + Bits::popLowestBit(_high);
+    }
+
+    inline constexpr uint64_t low() const {
+      return _low;
+    }
+    inline constexpr uint64_t high() const {
+      return _high;
+    }
+
+    inline CellMask operator&(const CellMask& other) const {
+      return{ _low & other._low, _high & other._high };
+    }
+    inline CellMask operator|(const CellMask& other) const {
+      return{ _low | other._low, _high | other._high };
+    }
+    inline CellMask operator^(const CellMask& other) const {
+      return{ _low ^ other._low, _high ^ other._high };
+    }
+    inline CellMask operator~() const {
+      return{ ~_low, ~_high };
+    }
+    inline CellMask& operator&=(const CellMask& other) {
+      _low &= other._low;
+      _high &= other._high;
+      return *this;
+    }
+    inline CellMask& operator|=(const CellMask& other) {
+      _low |= other._low;
+      _high |= other._high;
+      return *this;
+    }
+    inline CellMask& operator^=(const CellMask& other) {
+      _low ^= other._low;
+      _high ^= other._high;
+      return *this;
+    }
+    // Shifts are only ever by a column or a row so the amount is always in (0, 64).
+    inline CellMask operator<<(int amount) const {
+      ARC_ASSERT(amount > 0 && amount < 64);
+      return{ _low << amount, (_high << amount) | (_low >> (64 - amount)) };
+    }
+    inline CellMask operator>>(int amount) const {
+      ARC_ASSERT(amount > 0 && amount < 64);
+      return{ (_low >> amount) | (_high << (64 - amount)), _high >> amount };
+    }
+
+    inline bool operator==(const CellMask& other) const {
+      return _low == other._low && _high == other._high;
+    }
+    inline bool operator!=(const CellMask& other) const {
+      return !(*this == other);
+    }
+  private:
+    uint64_t _low;
+    uint64_t _high;
+  };
+}
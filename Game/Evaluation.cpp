@@ -0,0 +1,14 @@
+#include "pch.h"
+
+#include "Evaluation.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+int Quoridor::evaluate(const Board& board) {
+  const Player player = board.currentPlayer();
+  const Player opponent = opponentOf(player);
+  const int distanceLead = board.goalDistance(opponent) - board.goalDistance(player);
+  const int wallLead = board.wallCount(player) - board.wallCount(opponent);
+  return distanceLead * DISTANCE_WEIGHT + wallLead * WALL_WEIGHT + TEMPO_WEIGHT;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Board.hpp"
+
+namespace Quoridor {
+
+  // Scores are in hundredths of a step, from the point of view of the side to move.
+  const int INFINITE_SCORE = 32000;
+  const int WIN_SCORE = 30000;
+  // Any score past this is a forced win or loss, the distance from WIN_SCORE being the plies to it.
+  const int WIN_THRESHOLD = WIN_SCORE - 1000;
+
+  const int DISTANCE_WEIGHT = 100;
+  const int WALL_WEIGHT = 30;
+  const int TEMPO_WEIGHT = 50;
+
+  inline bool isWinScore(int score) {
+    return score > WIN_THRESHOLD || score < -WIN_THRESHOLD;
+  }
+
+  // Static evaluation of a position that has goal distances enabled: the race between the two pawns,
+  // plus a little for walls in hand and for having the move.
+  int evaluate(const Board& board);
+}
@@ -0,0 +1,245 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "Board.hpp"
+#include "BoardGeometry.hpp"
+#include "Util/Arc_Assert.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+namespace {
+  // Room for every square, rounded up to a power of two so indices are masked into range.
+  const int QUEUE_CAPACITY = 128;
+  const int QUEUE_MASK = QUEUE_CAPACITY - 1;
+  static_assert(QUEUE_CAPACITY >= CELL_COUNT, "Each queue must hold every square once");
+
+  // Squares waiting to be visited in order of distance. Seeds are sorted up front and everything
+  // found from them is one further than the square it was found from, so it comes off a plain FIFO
+  // already in order and the two only need merging. Each square is pushed at most once per queue.
+  class DistanceQueue {
+  public:
+    DistanceQueue()
+      : _seedCount(0)
+      , _seedHead(0)
+      , _head(0)
+      , _tail(0)
+    {}
+
+    void addSeed(int cell, int distance) {
+      ARC_ASSERT(_seedCount < CELL_COUNT);
+      int i = _seedCount++ & QUEUE_MASK;
+      while (i > 0 && _seedDistances[i - 1] > distance) {
+        _seeds[i] = _seeds[i - 1];
+        _seedDistances[i] = _seedDistances[i - 1];
+        --i;
+      }
+      _seeds[i] = static_cast<uint8_t>(cell);
+      _seedDistances[i] = static_cast<uint8_t>(distance);
+    }
+    void push(int cell, int distance) {
+      ARC_ASSERT(_tail - _head < CELL_COUNT);
+      _queue[_tail & QUEUE_MASK] = static_cast<uint8_t>(cell);
+      _queueDistances[_tail & QUEUE_MASK] = static_cast<uint8_t>(distance);
+      ++_tail;
+    }
+    bool pop(int& cell, int& distance) {
+      const int seed = _seedHead & QUEUE_MASK;
+      const int queued = _head & QUEUE_MASK;
+      const bool haveSeed = _seedHead < _seedCount;
+      const bool haveQueued = _head < _tail;
+      if (haveSeed && (!haveQueued || _seedDistances[seed] <= _queueDistances[queued])) {
+        cell = _seeds[seed];
+        distance = _seedDistances[seed];
+        ++_seedHead;
+        return true;
+      }
+      if (haveQueued) {
+        cell = _queue[queued];
+        distance = _queueDistances[queued];
+        ++_head;
+        return true;
+      }
+      return false;
+    }
+  private:
+    uint8_t _seeds[QUEUE_CAPACITY];
+    uint8_t _seedDistances[QUEUE_CAPACITY];
+    uint8_t _queue[QUEUE_CAPACITY];
+    uint8_t _queueDistances[QUEUE_CAPACITY];
+    int _seedCount;
+    int _seedHead;
+    int _head;
+    int _tail;
+  };
+}
+
+const uint8_t GoalDistances::UNREACHABLE;
+
+GoalDistances::GoalDistances(const WallsState& walls) {
+  recompute(PLAYER_ONE, walls);
+  recompute(PLAYER_TWO, walls);
+}
+
+void GoalDistances::recompute(Player player, const WallsState& walls) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  uint8_t* distances = _distances[player];
+  fill(distances, distances + CELL_COUNT, UNREACHABLE);
+
+  DistanceQueue queue;
+  CellMask goal = geometry.goalCells(player);
+  while (goal.any()) {
+    const int cell = goal.popLowestCell();
+    distances[cell] = 0;
+    queue.push(cell, 0);
+  }
+  int cell;
+  int distance;
+  while (queue.pop(cell, distance)) {
+    const uint8_t open = walls.openDirections(cell);
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(cell, direction);
+        if (distances[next] == UNREACHABLE) {
+          distances[next] = static_cast<uint8_t>(distance + 1);
+          queue.push(next, distance + 1);
+        }
+      }
+    }
+  }
+}
+
+void GoalDistances::wallPlaced(const WallsState& walls, int8_t centerX, int8_t centerY, MoveType type) {
+  _wallMarks.push_back(static_cast<uint16_t>(_changes.size()));
+
+  int cutEdges[2][2];
+  if (type == PLACE_VERTICAL_WALL) {
+    cutEdges[0][0] = cellIndex(centerX, centerY);
+    cutEdges[0][1] = cellIndex(centerX + 1, centerY);
+    cutEdges[1][0] = cellIndex(centerX, centerY + 1);
+    cutEdges[1][1] = cellIndex(centerX + 1, centerY + 1);
+  }
+  else {
+    cutEdges[0][0] = cellIndex(centerX, centerY);
+    cutEdges[0][1] = cellIndex(centerX, centerY + 1);
+    cutEdges[1][0] = cellIndex(centerX + 1, centerY);
+    cutEdges[1][1] = cellIndex(centerX + 1, centerY + 1);
+  }
+  update(PLAYER_ONE, walls, cutEdges);
+  update(PLAYER_TWO, walls, cutEdges);
+}
+
+void GoalDistances::wallRemoved() {
+  ARC_ASSERT(!_wallMarks.empty());
+  const size_t mark = _wallMarks.back();
+  _wallMarks.pop_back();
+  while (_changes.size() > mark) {
+    const Change& change = _changes.back();
+    _distances[change.player][change.cell] = change.distance;
+    _changes.pop_back();
+  }
+}
+
+void GoalDistances::update(Player player, const WallsState& walls, const int (&cutEdges)[2][2]) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  uint8_t* distances = _distances[player];
+
+  // Only the far end of a cut edge that was on a shortest route can get longer.
+  DistanceQueue candidates;
+  bool queued[CELL_COUNT] = {};
+  for (int edge = 0; edge < 2; ++edge) {
+    const int a = cutEdges[edge][0];
+    const int b = cutEdges[edge][1];
+    if (distances[b] != UNREACHABLE && distances[a] == distances[b] + 1) {
+      candidates.addSeed(a, distances[a]);
+      queued[a] = true;
+    }
+    else if (distances[a] != UNREACHABLE && distances[b] == distances[a] + 1) {
+      candidates.addSeed(b, distances[b]);
+      queued[b] = true;
+    }
+  }
+
+  // Find every square that no longer has a neighbour one step closer to the goal. Squares come off the
+  // queue in order of distance so by the time a square is looked at its parents are all settled.
+  bool affected[CELL_COUNT] = {};
+  uint8_t affectedCells[CELL_COUNT];
+  int affectedCount = 0;
+  int cell;
+  int distance;
+  while (candidates.pop(cell, distance)) {
+    const uint8_t open = walls.openDirections(cell);
+    bool supported = false;
+    for (int direction = 0; direction < DIRECTION_COUNT && !supported; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(cell, direction);
+        supported = !affected[next] && distances[next] + 1 == distance;
+      }
+    }
+    if (supported) {
+      continue;
+    }
+    affected[cell] = true;
+    affectedCells[affectedCount++] = static_cast<uint8_t>(cell);
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(cell, direction);
+        if (!queued[next] && distances[next] == distance + 1) {
+          queued[next] = true;
+          candidates.push(next, distance + 1);
+        }
+      }
+    }
+  }
+  if (affectedCount == 0) {
+    return;
+  }
+
+  // Rebuild the affected squares outwards from the best distance each can get from an unaffected
+  // neighbour.
+  uint8_t newDistances[CELL_COUNT];
+  DistanceQueue queue;
+  for (int i = 0; i < affectedCount; ++i) {
+    const int affectedCell = affectedCells[i];
+    const uint8_t open = walls.openDirections(affectedCell);
+    int best = UNREACHABLE;
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(affectedCell, direction);
+        if (!affected[next] && distances[next] != UNREACHABLE) {
+          best = min(best, distances[next] + 1);
+        }
+      }
+    }
+    newDistances[affectedCell] = static_cast<uint8_t>(best);
+    if (best != UNREACHABLE) {
+      queue.addSeed(affectedCell, best);
+    }
+  }
+  bool settled[CELL_COUNT] = {};
+  while (queue.pop(cell, distance)) {
+    if (settled[cell] || newDistances[cell] != distance) {
+      continue;
+    }
+    settled[cell] = true;
+    const uint8_t open = walls.openDirections(cell);
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(cell, direction);
+        if (affected[next] && !settled[next] && distance + 1 < newDistances[next]) {
+          newDistances[next] = static_cast<uint8_t>(distance + 1);
+          queue.push(next, distance + 1);
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < affectedCount; ++i) {
+    const int affectedCell = affectedCells[i];
+    if (newDistances[affectedCell] != distances[affectedCell]) {
+      _changes.push_back({ player, static_cast<uint8_t>(affectedCell), distances[affectedCell] });
+      distances[affectedCell] = newDistances[affectedCell];
+    }
+  }
+}
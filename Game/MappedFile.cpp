@@ -0,0 +1,166 @@
+#include "pch.h"
+
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+#if defined(_WIN32)
+
+// Only the FromApp mapping calls are available to store apps, and they exist everywhere from Windows 10.
+static wstring widen(const string& path) {
+  const int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  if (length <= 0) {
+    return wstring();
+  }
+  vector<wchar_t> wide(length);
+  MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wide.data(), length);
+  return wstring(wide.data());
+}
+
+MappedFile::MappedFile()
+  : _data(nullptr)
+  , _size(0)
+  , _file(INVALID_HANDLE_VALUE)
+  , _mapping(nullptr)
+{ }
+
+bool MappedFile::map(const string& path, size_t bytes, bool writable) {
+  close();
+  _file = CreateFile2(widen(path).c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+    FILE_SHARE_READ, writable ? CREATE_ALWAYS : OPEN_EXISTING, nullptr);
+  if (_file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  if (!writable) {
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_file, &fileSize)) {
+      close();
+      return false;
+    }
+    bytes = static_cast<size_t>(fileSize.QuadPart);
+  }
+  if (bytes == 0) {
+    close();
+    return false;
+  }
+  // Mapping more than the file holds grows it, and the new bytes read as zero.
+  _mapping = CreateFileMappingFromApp(_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, bytes, nullptr);
+  if (_mapping == nullptr) {
+    close();
+    return false;
+  }
+  _data = static_cast<uint8_t*>(MapViewOfFileFromApp(_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, bytes));
+  if (_data == nullptr) {
+    close();
+    return false;
+  }
+  _size = bytes;
+  return true;
+}
+
+void MappedFile::close() {
+  if (_data != nullptr) {
+    UnmapViewOfFile(_data);
+    _data = nullptr;
+  }
+  if (_mapping != nullptr) {
+    CloseHandle(_mapping);
+    _mapping = nullptr;
+  }
+  if (_file != INVALID_HANDLE_VALUE) {
+    CloseHandle(_file);
+    _file = INVALID_HANDLE_VALUE;
+  }
+  _size = 0;
+}
+
+void MappedFile::flush() {
+  if (_data != nullptr) {
+    FlushViewOfFile(_data, 0);
+  }
+}
+
+#else
+
+MappedFile::MappedFile()
+  : _data(nullptr)
+  , _size(0)
+  , _file(-1)
+{ }
+
+bool MappedFile::map(const string& path, size_t bytes, bool writable) {
+  close();
+  _file = writable ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+  if (_file < 0) {
+    return false;
+  }
+  if (writable) {
+    // The file was just truncated, so growing it leaves every byte zero.
+    if (ftruncate(_file, static_cast<off_t>(bytes)) != 0) {
+      close();
+      return false;
+    }
+  }
+  else {
+    struct stat status;
+    if (fstat(_file, &status) != 0) {
+      close();
+      return false;
+    }
+    bytes = static_cast<size_t>(status.st_size);
+  }
+  if (bytes == 0) {
+    close();
+    return false;
+  }
+  void* data = mmap(nullptr, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, _file, 0);
+  if (data == MAP_FAILED) {
+    close();
+    return false;
+  }
+  _data = static_cast<uint8_t*>(data);
+  _size = bytes;
+  return true;
+}
+
+void MappedFile::close() {
+  if (_data != nullptr) {
+    munmap(_data, _size);
+    _data = nullptr;
+  }
+  if (_file >= 0) {
+    ::close(_file);
+    _file = -1;
+  }
+  _size = 0;
+}
+
+void MappedFile::flush() {
+  if (_data != nullptr) {
+    msync(_data, _size, MS_ASYNC);
+  }
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::create(const string& path, size_t bytes) {
+  return map(path, bytes, true);
+}
+
+bool MappedFile::open(const string& path) {
+  return map(path, 0, false);
+}
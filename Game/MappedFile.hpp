@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Quoridor {
+
+  // A whole file mapped into memory, so tables larger than we would like to read up front are paged
+  // in on demand and written back by the operating system.
+  class MappedFile {
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    // Creates or truncates the file at the given size, zero filled and writable. False on failure.
+    bool create(const std::string& path, size_t bytes);
+    // Maps an existing file read only. False on failure.
+    bool open(const std::string& path);
+    void close();
+
+    // Starts writing back changed pages without waiting for them.
+    void flush();
+
+    inline bool isOpen() const {
+      return _data != nullptr;
+    }
+    inline uint8_t* data() {
+      return _data;
+    }
+    inline const uint8_t* data() const {
+      return _data;
+    }
+    inline size_t size() const {
+      return _size;
+    }
+  private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool map(const std::string& path, size_t bytes, bool writable);
+
+    uint8_t* _data;
+    size_t _size;
+#if defined(_WIN32)
+    void* _file;
+    void* _mapping;
+#else
+    int _file;
+#endif
+  };
+}
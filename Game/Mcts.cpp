@@ -0,0 +1,296 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "BoardGeometry.hpp"
+#include "Evaluation.hpp"
+#include "Mcts.hpp"
+#include "PawnRace.hpp"
+#include "Rollout.hpp"
+#include "Util/Random.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+// Deepest a simulation will walk down the tree before scoring where it is.
+static const int MAX_TREE_DEPTH = 256;
+// How often, in simulations, the clock is looked at.
+static const uint64_t TIME_CHECK_INTERVAL = 64;
+// How often, in simulations, the most visited root move is reported to a time manager.
+static const uint64_t TIME_CHECKPOINT_INTERVAL = 4096;
+// An evaluation this many hundredths of a step in front counts as about a 73% chance of winning.
+static const float VALUE_SCALE = 250.0f;
+// Unvisited moves are assumed a little worse than even, so well visited good moves are preferred
+// over trying every move once.
+static const float FIRST_PLAY_VALUE = 0.4f;
+
+static const float PRIOR_STEP_FORWARD = 4.0f;
+static const float PRIOR_STEP_SIDEWAYS = 1.0f;
+static const float PRIOR_STEP_BACK = 0.25f;
+static const float PRIOR_PROMISING_WALL = 1.0f;
+static const float PRIOR_OTHER_WALL = 0.1f;
+// Largest share by which a seeded engine scales a prior up or down.
+static const float PRIOR_NOISE = 0.25f;
+
+// Marks an edge whose child some thread is busy expanding. Never dereferenced.
+static MctsNode EXPANDING_NODE;
+static MctsNode* const EXPANDING = &EXPANDING_NODE;
+
+static void addValue(atomic<float>& sum, float value) {
+  float current = sum.load(memory_order_relaxed);
+  while (!sum.compare_exchange_weak(current, current + value, memory_order_relaxed)) {
+  }
+}
+
+static const MctsEdge& mostVisited(const MctsNode& node) {
+  const MctsEdge* best = &node.edges[0];
+  for (int i = 1; i < node.edgeCount; ++i) {
+    if (node.edges[i].visits.load(memory_order_relaxed) > best->visits.load(memory_order_relaxed)) {
+      best = &node.edges[i];
+    }
+  }
+  return *best;
+}
+
+struct MctsEngine::SharedState {
+  SharedState()
+    : start(chrono::steady_clock::now())
+    , simulations(0)
+    , nodes(0)
+    , raceTablesBuilt(0)
+    , stop(false)
+  {}
+
+  const chrono::steady_clock::time_point start;
+  atomic<uint64_t> simulations;
+  atomic<uint64_t> nodes;
+  atomic<uint64_t> raceTablesBuilt;
+  atomic<bool> stop;
+};
+
+MctsEngine::MctsEngine(size_t arenaMegabytes, int threadCount)
+  : _arena(arenaMegabytes << 20)
+  , _exploration(DEFAULT_EXPLORATION)
+  , _seed(0)
+  , _rolloutPlies(0)
+  , _timeCheckpoints(true)
+{
+  setThreadCount(threadCount);
+}
+
+void MctsEngine::setThreadCount(int threadCount) {
+  _threadCount = threadCount > 0 ? threadCount : max(1, static_cast<int>(thread::hardware_concurrency()));
+}
+
+MctsResult MctsEngine::search(const Board& board, const MctsLimits& limits) {
+  SharedState state;
+  _arena.reset();
+  Board start = board;
+  start.enableGoalDistances();
+
+  MctsResult result;
+  result.arenaCapacity = _arena.capacity();
+  if (start.winner()) {
+    return result;
+  }
+  uint64_t randomState = _seed;
+  MctsNode* root = expand(start, randomState);
+  if (root == nullptr || root->edgeCount == 0) {
+    return result;
+  }
+  state.nodes = 1;
+
+  vector<thread> helpers;
+  for (int i = 1; i < _threadCount; ++i) {
+    const uint64_t threadState = Random::splitMix64(randomState);
+    helpers.emplace_back([this, &start, root, &limits, &state, threadState]() {
+      runSimulations(start, *root, limits, state, threadState, false);
+    });
+  }
+  runSimulations(start, *root, limits, state, randomState, _timeCheckpoints);
+  for (thread& helper : helpers) {
+    helper.join();
+  }
+
+  const MctsEdge* best = &mostVisited(*root);
+  for (int i = 0; i < root->edgeCount; ++i) {
+    const MctsEdge& edge = root->edges[i];
+    result.rootMoves.emplace_back(edge.move, edge.visits, edge.valueSum);
+  }
+  result.bestMove = best->move;
+  result.winRate = best->visits > 0 ? best->valueSum / best->visits : 0;
+  result.simulations = min(state.simulations.load(), limits.maxSimulations != 0 ? limits.maxSimulations : UINT64_MAX);
+  result.nodes = state.nodes;
+  result.seconds = chrono::duration<double>(chrono::steady_clock::now() - state.start).count();
+  result.arenaBytesUsed = _arena.used();
+  result.raceTablesBuilt = state.raceTablesBuilt;
+  return result;
+}
+
+void MctsEngine::runSimulations(const Board& startBoard, MctsNode& root, const MctsLimits& limits, SharedState& state,
+  uint64_t randomState, bool reportsCheckpoints) {
+  Board board = startBoard;
+  RolloutPolicy rollouts(Random::splitMix64(randomState));
+  PawnRaceSolver raceSolver;
+  vector<MctsEdge*> edges;
+  vector<MoveUndo> undos;
+  edges.reserve(MAX_TREE_DEPTH);
+  undos.reserve(MAX_TREE_DEPTH);
+
+  for (uint64_t own = 0; !state.stop.load(memory_order_relaxed); ++own) {
+    if (limits.maxTime.count() != 0 && own % TIME_CHECK_INTERVAL == 0
+        && chrono::steady_clock::now() - state.start >= limits.maxTime) {
+      state.stop = true;
+      break;
+    }
+    if (limits.timeManager) {
+      const bool stop = reportsCheckpoints && own != 0 && own % TIME_CHECKPOINT_INTERVAL == 0
+        ? limits.timeManager->checkpoint(mostVisited(root).move)
+        : limits.timeManager->poll(own);
+      if (stop) {
+        state.stop = true;
+        break;
+      }
+    }
+    const uint64_t simulation = state.simulations.fetch_add(1, memory_order_relaxed);
+    if (limits.maxSimulations != 0 && simulation >= limits.maxSimulations) {
+      state.stop = true;
+      break;
+    }
+
+    // Walk down to the first move not yet in the tree, or to the end of the game, counting the
+    // visits on the way so other threads already see them.
+    MctsNode* node = &root;
+    float value;
+    while (true) {
+      MctsEdge& edge = select(*node);
+      node->visits.fetch_add(1, memory_order_relaxed);
+      edge.visits.fetch_add(1, memory_order_relaxed);
+      edges.push_back(&edge);
+      undos.push_back(board.doMove(edge.move));
+      if (board.winner()) {
+        // The side to move has lost.
+        value = 0;
+        break;
+      }
+
+      MctsNode* child = edge.child.load(memory_order_acquire);
+      if (child == nullptr) {
+        value = leafValue(board, rollouts, raceSolver);
+        MctsNode* expected = nullptr;
+        if (edge.child.compare_exchange_strong(expected, EXPANDING, memory_order_relaxed)) {
+          MctsNode* expanded = expand(board, randomState);
+          if (expanded != nullptr) {
+            state.nodes.fetch_add(1, memory_order_relaxed);
+          }
+          else {
+            state.stop = true;
+          }
+          // Publishes the finished node, or leaves the edge to be scored as a leaf for good.
+          edge.child.store(expanded != nullptr ? expanded : EXPANDING, memory_order_release);
+        }
+        break;
+      }
+      if (child == EXPANDING || static_cast<int>(edges.size()) >= MAX_TREE_DEPTH) {
+        value = leafValue(board, rollouts, raceSolver);
+        break;
+      }
+      node = child;
+    }
+
+    // Value is for the side to move at the leaf, so the last move's mover gets the opposite. The
+    // visits were already counted on the way down.
+    float moverResult = 1 - value;
+    for (int i = static_cast<int>(edges.size()) - 1; i >= 0; --i) {
+      addValue(edges[i]->valueSum, moverResult);
+      moverResult = 1 - moverResult;
+      board.undoMove(undos[i]);
+    }
+    edges.clear();
+    undos.clear();
+  }
+  state.raceTablesBuilt += raceSolver.tablesBuilt();
+}
+
+MctsNode* MctsEngine::expand(const Board& board, uint64_t& randomState) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  const Player player = board.currentPlayer();
+  MoveList moves;
+  board.availablePieceMovesForPlayer(player, moves);
+  const int pieceMoves = moves.size();
+  board.availableWallPlacementsForPlayer(player, moves, PROMISING_WALLS);
+  const int promisingWalls = moves.size();
+  board.availableWallPlacementsForPlayer(player, moves, UNPROMISING_WALLS);
+
+  MctsNode* node = _arena.allocateArray<MctsNode>(1);
+  MctsEdge* edges = _arena.allocateArray<MctsEdge>(moves.size());
+  if (node == nullptr || edges == nullptr) {
+    return nullptr;
+  }
+
+  const int cell = cellIndex(board.playerPosition(player));
+  const int distance = board.goalDistance(player);
+  float total = 0;
+  for (int i = 0; i < moves.size(); ++i) {
+    const Move& move = moves[i];
+    float prior;
+    if (i < pieceMoves) {
+      const int destination = move.type == MOVE_PIECE
+        ? geometry.neighbour(cell, move.info.pieceMoveDirection)
+        : cellIndex(move.info.jumpDestination);
+      const int after = board.goalDistances().distance(player, destination);
+      prior = after < distance ? PRIOR_STEP_FORWARD : (after == distance ? PRIOR_STEP_SIDEWAYS : PRIOR_STEP_BACK);
+    }
+    else {
+      prior = i < promisingWalls ? PRIOR_PROMISING_WALL : PRIOR_OTHER_WALL;
+    }
+    if (_seed != 0) {
+      prior *= 1 + PRIOR_NOISE * (2 * Random::toUnitFloat(Random::splitMix64(randomState)) - 1);
+    }
+    edges[i].move = move;
+    edges[i].prior = prior;
+    total += prior;
+  }
+  for (int i = 0; i < moves.size(); ++i) {
+    edges[i].prior /= total;
+  }
+
+  node->edges = edges;
+  node->edgeCount = static_cast<uint16_t>(moves.size());
+  return node;
+}
+
+MctsEdge& MctsEngine::select(const MctsNode& node) const {
+  const float explorationScale = _exploration * sqrt(static_cast<float>(node.visits.load(memory_order_relaxed) + 1));
+  MctsEdge* best = &node.edges[0];
+  float bestScore = -1;
+  for (int i = 0; i < node.edgeCount; ++i) {
+    MctsEdge& edge = node.edges[i];
+    const uint32_t visits = edge.visits.load(memory_order_relaxed);
+    const float value = visits > 0 ? edge.valueSum.load(memory_order_relaxed) / visits : FIRST_PLAY_VALUE;
+    const float score = value + explorationScale * edge.prior / (1 + visits);
+    if (score > bestScore) {
+      bestScore = score;
+      best = &edge;
+    }
+  }
+  return *best;
+}
+
+float MctsEngine::leafValue(Board& board, RolloutPolicy& rollouts, PawnRaceSolver& raceSolver) const {
+  const boost::optional<RaceOutcome> race = raceSolver.solve(board);
+  if (race) {
+    return !race->winner ? 0.5f : (*race->winner == board.currentPlayer() ? 1.0f : 0.0f);
+  }
+  if (_rolloutPlies <= 0) {
+    return 1 / (1 + exp(-evaluate(board) / VALUE_SCALE));
+  }
+  const RolloutResult result = rollouts.play(board, _rolloutPlies);
+  if (result.winner) {
+    return *result.winner == board.currentPlayer() ? 1.0f : 0.0f;
+  }
+  return 1 / (1 + exp(-result.evaluation / VALUE_SCALE));
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Board.hpp"
+#include "TimeManager.hpp"
+
+namespace Quoridor {
+
+  const size_t DEFAULT_MCTS_ARENA_MEGABYTES = 64;
+  const float DEFAULT_EXPLORATION = 1.5f;
+
+  struct MctsNode;
+  class PawnRaceSolver;
+  class RolloutPolicy;
+
+  // Statistics live on the edges, so choosing a child reads one contiguous array. Every field a
+  // search thread writes is atomic, so any number of threads can share the tree.
+  struct MctsEdge {
+    MctsEdge()
+      : child(nullptr)
+      , visits(0)
+      , valueSum(0)
+      , prior(0)
+      , move(PLAYER_ONE, UP)
+    {}
+
+    // Null until expanded, then briefly a placeholder while one thread expands it.
+    std::atomic<MctsNode*> child;
+    // Counted as soon as a thread starts down the edge, before its result is known. Until the result
+    // is added the visit scores as a loss, which steers other threads elsewhere (virtual loss).
+    std::atomic<uint32_t> visits;
+    // Sum of the results for the player making the move, each between 0 and 1.
+    std::atomic<float> valueSum;
+    float prior;
+    Move move;
+  };
+
+  struct MctsNode {
+    MctsNode()
+      : edges(nullptr)
+      , visits(0)
+      , edgeCount(0)
+    {}
+
+    MctsEdge* edges;
+    std::atomic<uint32_t> visits;
+    uint16_t edgeCount;
+  };
+
+  // Totals for one move at the root.
+  struct MctsMoveStats {
+    MctsMoveStats(const Move& move, uint32_t visits, double valueSum)
+      : move(move)
+      , visits(visits)
+      , valueSum(valueSum)
+    {}
+
+    Move move;
+    uint32_t visits;
+    double valueSum;
+  };
+
+  struct MctsLimits {
+    MctsLimits()
+      : maxSimulations(0)
+      , maxTime(0)
+      , timeManager(nullptr)
+    {}
+
+    // Zero means no limit, but at least one limit should be set. The search also ends early when
+    // the arena is full.
+    uint64_t maxSimulations;
+    std::chrono::milliseconds maxTime;
+    // Game clock deadlines for the move, already started. Every thread polls it once per simulation
+    // and the first thread reports the most visited root move every few thousand simulations.
+    TimeManager* timeManager;
+  };
+
+  struct MctsResult {
+    MctsResult()
+      : winRate(0)
+      , simulations(0)
+      , nodes(0)
+      , seconds(0)
+      , arenaBytesUsed(0)
+      , arenaCapacity(0)
+      , raceTablesBuilt(0)
+    {}
+
+    inline double simulationsPerSecond() const {
+      return seconds > 0 ? simulations / seconds : 0;
+    }
+    inline double nodesPerSecond() const {
+      return seconds > 0 ? nodes / seconds : 0;
+    }
+
+    // The most visited move at the root.
+    boost::optional<Move> bestMove;
+    // Mean result of the best move for the side to move, 0 to 1.
+    double winRate;
+    uint64_t simulations;
+    // Nodes expanded, each with its own array of edges.
+    uint64_t nodes;
+    double seconds;
+    size_t arenaBytesUsed;
+    size_t arenaCapacity;
+    // Pawn race tables the threads had to build, see PawnRaceSolver.
+    uint64_t raceTablesBuilt;
+    // Every legal move at the root, in move generation order.
+    std::vector<MctsMoveStats> rootMoves;
+  };
+
+  // Monte Carlo tree search with PUCT selection. Leaves are scored with the static evaluation, or
+  // optionally with a short rollout, or exactly once the walls have run out. Priors favour pawn moves
+  // toward the goal and promising walls. All nodes and edges come out of an arena that is reset at
+  // the start of each search.
+  //
+  // With more than one thread, all threads work on the one tree without locks. Counters are updated
+  // atomically, virtual loss spreads the threads over different lines, and a thread claims a leaf for
+  // expansion with a compare and swap. Others reaching a leaf being expanded just score it and move on.
+  class MctsEngine {
+  public:
+    // A thread count of zero means one per hardware thread.
+    explicit MctsEngine(size_t arenaMegabytes = DEFAULT_MCTS_ARENA_MEGABYTES, int threadCount = 1);
+
+    MctsResult search(const Board& board, const MctsLimits& limits);
+
+    void setThreadCount(int threadCount);
+    inline int threadCount() const {
+      return _threadCount;
+    }
+    inline void setExplorationConstant(float exploration) {
+      _exploration = exploration;
+    }
+    // Plies of rollout played from each leaf, which then scores by who won or by the evaluation
+    // where the rollout stopped. Zero, the default, scores leaves with the evaluation alone.
+    inline void setRolloutPlies(int plies) {
+      _rolloutPlies = plies;
+    }
+    // A seed other than zero shakes up the priors a little, so engines given different seeds grow
+    // different trees from the same position. Zero keeps the priors as they are.
+    inline void setSeed(uint64_t seed) {
+      _seed = seed;
+    }
+
+    // Whether the engine reports its best move to the limits' time manager. When several engines
+    // share a manager, only one of them should. On by default.
+    inline void setTimeCheckpoints(bool timeCheckpoints) {
+      _timeCheckpoints = timeCheckpoints;
+    }
+
+    // Sizes for planning deployments, a node costs one node plus one edge per legal move.
+    static inline size_t nodeSize() {
+      return sizeof(MctsNode);
+    }
+    static inline size_t edgeSize() {
+      return sizeof(MctsEdge);
+    }
+  private:
+    struct SharedState;
+
+    void runSimulations(const Board& board, MctsNode& root, const MctsLimits& limits, SharedState& state,
+      uint64_t randomState, bool reportsCheckpoints);
+    // Null when the arena is out of room.
+    MctsNode* expand(const Board& board, uint64_t& randomState);
+    MctsEdge& select(const MctsNode& node) const;
+    float leafValue(Board& board, RolloutPolicy& rollouts, PawnRaceSolver& raceSolver) const;
+
+    Arena _arena;
+    float _exploration;
+    uint64_t _seed;
+    int _rolloutPlies;
+    bool _timeCheckpoints;
+    int _threadCount;
+  };
+}
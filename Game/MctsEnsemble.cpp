@@ -0,0 +1,106 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "MctsEnsemble.hpp"
+#include "Util/Arc_Assert.hpp"
+#include "Util/Random.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+MctsEnsemble::MctsEnsemble(int treeCount, size_t arenaMegabytesPerTree, uint64_t seed)
+  : _arenaMegabytes(arenaMegabytesPerTree)
+  , _seed(seed)
+  , _exploration(DEFAULT_EXPLORATION)
+{
+  setTreeCount(treeCount);
+}
+
+void MctsEnsemble::setTreeCount(int treeCount) {
+  if (treeCount <= 0) {
+    treeCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+  }
+  _engines.clear();
+  uint64_t seedState = _seed;
+  for (int i = 0; i < treeCount; ++i) {
+    _engines.emplace_back(new MctsEngine(_arenaMegabytes, 1));
+    _engines.back()->setExplorationConstant(_exploration);
+    // The first tree speaks for all of them when a time manager is in use.
+    _engines.back()->setTimeCheckpoints(i == 0);
+    // A zero seed would turn the noise off for that tree.
+    _engines.back()->setSeed(Random::splitMix64(seedState) | 1);
+  }
+}
+
+void MctsEnsemble::setExplorationConstant(float exploration) {
+  _exploration = exploration;
+  for (auto& engine : _engines) {
+    engine->setExplorationConstant(exploration);
+  }
+}
+
+MctsResult MctsEnsemble::search(const Board& board, const MctsLimits& limits) {
+  const auto start = chrono::steady_clock::now();
+  const size_t treeCount = _engines.size();
+  vector<MctsLimits> treeLimits(treeCount, limits);
+  if (limits.maxSimulations != 0) {
+    for (size_t i = 0; i < treeCount; ++i) {
+      treeLimits[i].maxSimulations = limits.maxSimulations / treeCount + (i < limits.maxSimulations % treeCount ? 1 : 0);
+      if (treeLimits[i].maxSimulations == 0) {
+        // Zero would mean unlimited, so a tree with nothing to do runs one simulation instead.
+        treeLimits[i].maxSimulations = 1;
+      }
+    }
+  }
+
+  vector<MctsResult> results(treeCount);
+  vector<thread> helpers;
+  for (size_t i = 1; i < treeCount; ++i) {
+    helpers.emplace_back([this, &board, &treeLimits, &results, i]() {
+      results[i] = _engines[i]->search(board, treeLimits[i]);
+    });
+  }
+  results[0] = _engines[0]->search(board, treeLimits[0]);
+  for (thread& helper : helpers) {
+    helper.join();
+  }
+
+  MctsResult merged = results[0];
+  for (size_t i = 1; i < treeCount; ++i) {
+    const MctsResult& result = results[i];
+    merged.simulations += result.simulations;
+    merged.nodes += result.nodes;
+    merged.arenaBytesUsed += result.arenaBytesUsed;
+    merged.arenaCapacity += result.arenaCapacity;
+    merged.raceTablesBuilt += result.raceTablesBuilt;
+    if (merged.rootMoves.empty()) {
+      merged.rootMoves = result.rootMoves;
+      continue;
+    }
+    // Every tree generates the root moves in the same order.
+    ARC_ASSERT(result.rootMoves.empty() || result.rootMoves.size() == merged.rootMoves.size());
+    for (size_t m = 0; m < result.rootMoves.size(); ++m) {
+      ARC_ASSERT(result.rootMoves[m].move == merged.rootMoves[m].move);
+      merged.rootMoves[m].visits += result.rootMoves[m].visits;
+      merged.rootMoves[m].valueSum += result.rootMoves[m].valueSum;
+    }
+  }
+
+  merged.bestMove = boost::none;
+  merged.winRate = 0;
+  const MctsMoveStats* best = nullptr;
+  for (const MctsMoveStats& stats : merged.rootMoves) {
+    if (best == nullptr || stats.visits > best->visits) {
+      best = &stats;
+    }
+  }
+  if (best != nullptr) {
+    merged.bestMove = best->move;
+    merged.winRate = best->visits > 0 ? best->valueSum / best->visits : 0;
+  }
+  merged.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  return merged;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Mcts.hpp"
+
+namespace Quoridor {
+
+  // Root parallel MCTS. Each thread grows its own tree in its own arena, seeded differently so the
+  // trees explore differently, and nothing is shared while they run. At the end the root visits and
+  // values of all trees are added up move by move and the most visited move overall is played.
+  //
+  // Without any synchronisation this scales with the core count, at the cost of every tree
+  // rediscovering the same lines, so it suits batch analysis. MctsEngine with several threads is
+  // the shared tree alternative.
+  class MctsEnsemble {
+  public:
+    // A tree count of zero means one per hardware thread. Every tree gets an arena of the given size.
+    explicit MctsEnsemble(int treeCount = 0, size_t arenaMegabytesPerTree = DEFAULT_MCTS_ARENA_MEGABYTES,
+      uint64_t seed = 1);
+
+    void setTreeCount(int treeCount);
+    inline int treeCount() const {
+      return static_cast<int>(_engines.size());
+    }
+    void setExplorationConstant(float exploration);
+
+    // The simulation budget is split between the trees, while a time limit applies to each as they
+    // run side by side. Counts and arena usage in the result are totals over all trees.
+    MctsResult search(const Board& board, const MctsLimits& limits);
+  private:
+    size_t _arenaMegabytes;
+    uint64_t _seed;
+    float _exploration;
+    std::vector<std::unique_ptr<MctsEngine>> _engines;
+  };
+}
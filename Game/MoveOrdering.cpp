@@ -0,0 +1,261 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "BoardGeometry.hpp"
+#include "MoveOrdering.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+static const int NO_KILLER = -1;
+// Relative history is cutoffs per try, scaled to keep some precision.
+static const uint32_t HISTORY_SCALE = 1024;
+static const uint32_t HISTORY_LIMIT = 1u << 30;
+// Ordering of pawn moves by goal distance outweighs anything history says about them.
+static const int DISTANCE_SCORE = 1 << 20;
+static const int KILLER_SCORE = 1 << 16;
+
+//////////////////////////////////////////////////////////////////////////
+// Move Ids
+//////////////////////////////////////////////////////////////////////////
+
+MoveId Quoridor::moveId(const Move& move, Point from) {
+  switch (move.type) {
+  case MOVE_PIECE:
+    return static_cast<MoveId>(move.info.pieceMoveDirection);
+  case JUMP_PIECE: {
+    const int dx = move.info.jumpDestination.x() - from.x();
+    const int dy = move.info.jumpDestination.y() - from.y();
+    if (dx == 0) {
+      return static_cast<MoveId>(FIRST_JUMP_ID + (dy < 0 ? UP : DOWN));
+    }
+    if (dy == 0) {
+      return static_cast<MoveId>(FIRST_JUMP_ID + (dx < 0 ? LEFT : RIGHT));
+    }
+    return static_cast<MoveId>(FIRST_JUMP_ID + DIRECTION_COUNT + (dx > 0 ? 1 : 0) + (dy > 0 ? 2 : 0));
+  }
+  case PLACE_HORIZONAL_WALL:
+  case PLACE_VERTICAL_WALL: {
+    const int center = move.info.wallCenter.x() + move.info.wallCenter.y() * WALL_CENTERS_PER_ROW;
+    return static_cast<MoveId>(FIRST_WALL_ID + (move.type == PLACE_VERTICAL_WALL ? WALL_CENTER_COUNT : 0) + center);
+  }
+  default:
+    ARC_FAIL("Invalid move type!");
+    return 0;
+  }
+}
+
+Move Quoridor::moveFromId(MoveId id, Player player, Point from) {
+  ARC_ASSERT(id < MOVE_ID_COUNT);
+  if (id < FIRST_JUMP_ID) {
+    return Move(player, static_cast<Direction>(id));
+  }
+  if (id < FIRST_WALL_ID) {
+    const int kind = id - FIRST_JUMP_ID;
+    int dx;
+    int dy;
+    if (kind < DIRECTION_COUNT) {
+      static const int JUMP_X[DIRECTION_COUNT] = { 0, 0, -2, 2 };
+      static const int JUMP_Y[DIRECTION_COUNT] = { -2, 2, 0, 0 };
+      dx = JUMP_X[kind];
+      dy = JUMP_Y[kind];
+    }
+    else {
+      dx = (kind & 1) ? 1 : -1;
+      dy = (kind & 2) ? 1 : -1;
+    }
+    return Move(player, JUMP_PIECE, Point(from.x() + dx, from.y() + dy));
+  }
+  const int wall = id - FIRST_WALL_ID;
+  const MoveType type = wall < WALL_CENTER_COUNT ? PLACE_HORIZONAL_WALL : PLACE_VERTICAL_WALL;
+  const int center = wall % WALL_CENTER_COUNT;
+  return Move(player, type, Point(center % WALL_CENTERS_PER_ROW, center / WALL_CENTERS_PER_ROW));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Move Ordering
+//////////////////////////////////////////////////////////////////////////
+
+MoveOrdering::MoveOrdering() {
+  clear();
+}
+
+void MoveOrdering::clear() {
+  fill(&_killers[0][0], &_killers[0][0] + MAX_ORDERING_PLY * KILLERS_PER_PLY, NO_KILLER);
+  memset(_history, 0, sizeof(_history));
+  memset(_butterfly, 0, sizeof(_butterfly));
+}
+
+void MoveOrdering::newSearch() {
+  fill(&_killers[0][0], &_killers[0][0] + MAX_ORDERING_PLY * KILLERS_PER_PLY, NO_KILLER);
+  ageHistory();
+}
+
+void MoveOrdering::ageHistory() {
+  for (int player = 0; player < 2; ++player) {
+    for (int id = 0; id < MOVE_ID_COUNT; ++id) {
+      _history[player][id] /= 2;
+      _butterfly[player][id] /= 2;
+    }
+  }
+}
+
+void MoveOrdering::addKiller(int ply, MoveId id) {
+  if (ply >= MAX_ORDERING_PLY || _killers[ply][0] == id) {
+    return;
+  }
+  _killers[ply][1] = _killers[ply][0];
+  _killers[ply][0] = id;
+}
+
+void MoveOrdering::recordCutoff(Player player, MoveId best, const MoveId* tried, int triedCount, int depth) {
+  const uint32_t weight = static_cast<uint32_t>(depth * depth);
+  _history[player][best] += weight;
+  _butterfly[player][best] += weight;
+  uint32_t largest = _butterfly[player][best];
+  for (int i = 0; i < triedCount; ++i) {
+    _butterfly[player][tried[i]] += weight;
+    largest = max(largest, _butterfly[player][tried[i]]);
+  }
+  // Halved before any count can wrap around. The killers belong to the running search and stay.
+  if (largest > HISTORY_LIMIT) {
+    ageHistory();
+  }
+}
+
+int MoveOrdering::historyScore(Player player, MoveId id) const {
+  const uint32_t tries = _butterfly[player][id];
+  return tries == 0 ? 0 : static_cast<int>(static_cast<uint64_t>(_history[player][id]) * HISTORY_SCALE / tries);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Move Picker
+//////////////////////////////////////////////////////////////////////////
+
+MovePicker::MovePicker(const Board& board, const MoveOrdering& ordering, int ply, const boost::optional<Move>& hashMove,
+  bool promisingWallsOnly)
+  : _board(board)
+  , _ordering(ordering)
+  , _ply(min(ply, MAX_ORDERING_PLY - 1))
+  , _player(board.currentPlayer())
+  , _from(board.playerPosition(board.currentPlayer()))
+  , _promisingWallsOnly(promisingWallsOnly)
+  , _hashMove(hashMove)
+  , _stage(HASH_MOVE)
+  , _next(0)
+  , _killerSlot(0)
+{ }
+
+bool MovePicker::isHashMove(const Move& move) const {
+  return _hashMove && *_hashMove == move;
+}
+
+bool MovePicker::isKillerWall(const Move& move) const {
+  return move.type != MOVE_PIECE && move.type != JUMP_PIECE && _ordering.isKiller(_ply, moveId(move, _from));
+}
+
+void MovePicker::generateWalls(WallSelection selection) {
+  _moves.clear();
+  _board.availableWallPlacementsForPlayer(_player, _moves, selection);
+  for (int i = 0; i < _moves.size(); ++i) {
+    _scores[i] = _ordering.historyScore(_player, moveId(_moves[i], _from));
+  }
+  _next = 0;
+}
+
+boost::optional<Move> MovePicker::next() {
+  while (true) {
+    switch (_stage) {
+    case HASH_MOVE:
+      _stage = GENERATE_PIECE_MOVES;
+      if (_hashMove && _board.isLegal(*_hashMove)) {
+        return _hashMove;
+      }
+      // A hash move from a colliding position is simply ignored.
+      _hashMove = boost::none;
+      break;
+
+    case GENERATE_PIECE_MOVES: {
+      _moves.clear();
+      _board.availablePieceMovesForPlayer(_player, _moves);
+      const BoardGeometry& geometry = BoardGeometry::instance();
+      const int cell = cellIndex(_from);
+      for (int i = 0; i < _moves.size(); ++i) {
+        const Move& move = _moves[i];
+        const MoveId id = moveId(move, _from);
+        _scores[i] = _ordering.historyScore(_player, id) + (_ordering.isKiller(_ply, id) ? KILLER_SCORE : 0);
+        if (_board.hasGoalDistances()) {
+          const int destination = move.type == MOVE_PIECE
+            ? geometry.neighbour(cell, move.info.pieceMoveDirection)
+            : cellIndex(move.info.jumpDestination);
+          _scores[i] -= DISTANCE_SCORE * _board.goalDistances().distance(_player, destination);
+        }
+      }
+      _next = 0;
+      _stage = PIECE_MOVES;
+      break;
+    }
+
+    case PIECE_MOVES:
+    case WALLS:
+    case OTHER_WALLS:
+      // Selection sort as we go, most nodes are cut off long before the end of the list.
+      while (_next < _moves.size()) {
+        int best = _next;
+        for (int i = _next + 1; i < _moves.size(); ++i) {
+          if (_scores[i] > _scores[best]) {
+            best = i;
+          }
+        }
+        const Move move = _moves[best];
+        swap(_scores[best], _scores[_next]);
+        _moves[best] = _moves[_next];
+        _moves[_next] = move;
+        ++_next;
+        if (isHashMove(move) || (_stage != PIECE_MOVES && isKillerWall(move))) {
+          continue;
+        }
+        return move;
+      }
+      if (_stage == PIECE_MOVES) {
+        _stage = KILLERS;
+      }
+      else if (_stage == WALLS && !_promisingWallsOnly) {
+        _stage = GENERATE_OTHER_WALLS;
+      }
+      else {
+        _stage = DONE;
+      }
+      break;
+
+    case KILLERS:
+      while (_killerSlot < KILLERS_PER_PLY) {
+        const int id = _ordering.killer(_ply, _killerSlot++);
+        if (id < FIRST_WALL_ID) {
+          continue;
+        }
+        const Move move = moveFromId(static_cast<MoveId>(id), _player, _from);
+        if (!isHashMove(move) && _board.isLegal(move)) {
+          return move;
+        }
+      }
+      _stage = GENERATE_WALLS;
+      break;
+
+    case GENERATE_WALLS:
+      generateWalls(PROMISING_WALLS);
+      _stage = WALLS;
+      break;
+
+    case GENERATE_OTHER_WALLS:
+      generateWalls(UNPROMISING_WALLS);
+      _stage = OTHER_WALLS;
+      break;
+
+    case DONE:
+      return boost::none;
+    }
+  }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <cstdint>
+
+#include "Board.hpp"
+
+namespace Quoridor {
+
+  // Dense numbering of the moves a player can make, relative to their pawn so that it fits in a
+  // byte: steps, then jumps, then every wall.
+  typedef uint8_t MoveId;
+
+  // Straight jumps in each direction, then the diagonal ones.
+  const int JUMP_KINDS = 8;
+  const int FIRST_JUMP_ID = DIRECTION_COUNT;
+  const int FIRST_WALL_ID = FIRST_JUMP_ID + JUMP_KINDS;
+  const int MOVE_ID_COUNT = FIRST_WALL_ID + 2 * WALL_CENTER_COUNT;
+
+  // From is the moving player's pawn position.
+  MoveId moveId(const Move& move, Point from);
+  Move moveFromId(MoveId id, Player player, Point from);
+
+  const int MAX_ORDERING_PLY = 128;
+  const int KILLERS_PER_PLY = 2;
+
+  // Per thread statistics on which moves have caused cutoffs: two killer moves for each ply, and
+  // history counts kept next to butterfly counts of how often each move was tried at all, so that
+  // often tried moves don't crowd out rarely tried but effective ones.
+  class MoveOrdering {
+  public:
+    MoveOrdering();
+
+    void clear();
+    // Forgets the killers and halves the history, called between searches.
+    void newSearch();
+
+    void addKiller(int ply, MoveId id);
+    inline bool isKiller(int ply, MoveId id) const {
+      return _killers[ply][0] == id || _killers[ply][1] == id;
+    }
+    inline int killer(int ply, int slot) const {
+      return _killers[ply][slot];
+    }
+
+    // The move that caused a cutoff, and the moves that were searched before it without one.
+    void recordCutoff(Player player, MoveId best, const MoveId* tried, int triedCount, int depth);
+    // Relative history, higher is better.
+    int historyScore(Player player, MoveId id) const;
+  private:
+    // Halves every history and butterfly count, keeping their ratios.
+    void ageHistory();
+
+    // Killer slots hold an id, or NO_KILLER.
+    int _killers[MAX_ORDERING_PLY][KILLERS_PER_PLY];
+    uint32_t _history[2][MOVE_ID_COUNT];
+    uint32_t _butterfly[2][MOVE_ID_COUNT];
+  };
+
+  // Yields a node's moves in stages, best guesses first, generating each kind of move only once the
+  // earlier stages have failed to produce a cutoff:
+  //   1. the hash move,
+  //   2. pawn moves, the ones that bring the pawn closest to its goal first,
+  //   3. killer walls,
+  //   4. promising walls by history (see promisingWalls in Pathing.hpp),
+  //   5. the remaining walls by history, unless they are being pruned.
+  class MovePicker {
+  public:
+    MovePicker(const Board& board, const MoveOrdering& ordering, int ply, const boost::optional<Move>& hashMove,
+      bool promisingWallsOnly = false);
+
+    boost::optional<Move> next();
+  private:
+    enum Stage {
+      HASH_MOVE,
+      GENERATE_PIECE_MOVES,
+      PIECE_MOVES,
+      KILLERS,
+      GENERATE_WALLS,
+      WALLS,
+      GENERATE_OTHER_WALLS,
+      OTHER_WALLS,
+      DONE
+    };
+
+    bool isHashMove(const Move& move) const;
+    bool isKillerWall(const Move& move) const;
+    void generateWalls(WallSelection selection);
+
+    const Board& _board;
+    const MoveOrdering& _ordering;
+    const int _ply;
+    const Player _player;
+    const Point _from;
+    const bool _promisingWallsOnly;
+    boost::optional<Move> _hashMove;
+    Stage _stage;
+    MoveList _moves;
+    int _scores[MAX_MOVES];
+    int _next;
+    int _killerSlot;
+  };
+}
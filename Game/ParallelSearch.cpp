@@ -0,0 +1,73 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "ParallelSearch.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+ParallelSearch::ParallelSearch(ParallelSearchMode mode, int threadCount, size_t transpositionTableMegabytes)
+  : _mode(mode)
+  , _table(transpositionTableMegabytes)
+  , _activeMoves(new ActiveMoveTable())
+{
+  setThreadCount(threadCount);
+}
+
+void ParallelSearch::setThreadCount(int threadCount) {
+  if (threadCount <= 0) {
+    threadCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+  }
+  _engines.clear();
+  for (int i = 0; i < threadCount; ++i) {
+    _engines.emplace_back(new SearchEngine(_table));
+  }
+  _engines[0]->setIterationCallback(_onIteration);
+}
+
+void ParallelSearch::setIterationCallback(SearchEngine::IterationCallback callback) {
+  _onIteration = callback;
+  _engines[0]->setIterationCallback(_onIteration);
+}
+
+SearchResult ParallelSearch::search(const Board& board, const SearchLimits& limits) {
+  const auto start = chrono::steady_clock::now();
+  _table.newSearch();
+
+  SharedSearchState state;
+  if (_mode == ABDADA) {
+    state.activeMoves = _activeMoves.get();
+  }
+  vector<SearchResult> results(_engines.size());
+  vector<thread> helpers;
+  for (size_t i = 0; i < _engines.size(); ++i) {
+    _engines[i]->joinParallelSearch(&state, static_cast<int>(i), _mode == LAZY_SMP);
+  }
+  for (size_t i = 1; i < _engines.size(); ++i) {
+    helpers.emplace_back([this, &board, &limits, &results, i]() {
+      results[i] = _engines[i]->search(board, limits);
+    });
+  }
+  results[0] = _engines[0]->search(board, limits);
+  // Helpers keep going until the main thread is done, whatever depth they have reached.
+  state.stop = true;
+  for (thread& helper : helpers) {
+    helper.join();
+  }
+
+  SearchResult best = results[0];
+  uint64_t raceTablesBuilt = 0;
+  for (const SearchResult& result : results) {
+    if (result.bestMove && result.depth > best.depth) {
+      best = result;
+    }
+    raceTablesBuilt += result.raceTablesBuilt;
+  }
+  best.nodes = state.nodes;
+  best.raceTablesBuilt = raceTablesBuilt;
+  best.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  return best;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Search.hpp"
+#include "SharedTranspositionTable.hpp"
+
+namespace Quoridor {
+
+  enum ParallelSearchMode {
+    // Every thread runs its own iterative deepening search of the same root, with helpers staggered
+    // over different depths. The only thing they share is the transposition table, through which
+    // each thread's results speed up and reorder the others' searches.
+    LAZY_SMP,
+    // All threads search the same depths, but once the first move at a node has been searched a
+    // thread defers any move another thread is already busy with. The threads thus split the
+    // remaining moves of PV and cut nodes between them, much like Young Brothers Wait.
+    ABDADA
+  };
+
+  class ParallelSearch {
+  public:
+    // A thread count of zero means one per hardware thread.
+    explicit ParallelSearch(ParallelSearchMode mode = LAZY_SMP, int threadCount = 0,
+      size_t transpositionTableMegabytes = DEFAULT_TRANSPOSITION_TABLE_MEGABYTES);
+
+    void setThreadCount(int threadCount);
+    inline int threadCount() const {
+      return static_cast<int>(_engines.size());
+    }
+
+    inline void setMode(ParallelSearchMode mode) {
+      _mode = mode;
+    }
+    inline ParallelSearchMode mode() const {
+      return _mode;
+    }
+
+    // Limits apply to the search as a whole, the node budget covering all threads together. The
+    // result is the main thread's unless a helper completed a deeper iteration, and counts the nodes
+    // of every thread.
+    SearchResult search(const Board& board, const SearchLimits& limits);
+
+    // Called after each iteration completed by the main thread.
+    void setIterationCallback(SearchEngine::IterationCallback callback);
+
+    inline SharedTranspositionTable& transpositionTable() {
+      return _table;
+    }
+  private:
+    ParallelSearchMode _mode;
+    SharedTranspositionTable _table;
+    std::unique_ptr<ActiveMoveTable> _activeMoves;
+    std::vector<std::unique_ptr<SearchEngine>> _engines;
+    SearchEngine::IterationCallback _onIteration;
+  };
+}
@@ -0,0 +1,172 @@
+#include "pch.h"
+
+#include "Pathing.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+//////////////////////////////////////////////////////////////////////////
+// Wall Cut Filter
+//////////////////////////////////////////////////////////////////////////
+
+WallCutFilter::WallCutFilter(const WallsState& walls) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  _touchedCorners = geometry.borderCorners();
+  uint64_t horizontal = walls.horizontalWalls();
+  while (horizontal != 0) {
+    _touchedCorners |= geometry.horizontalWallCorners(Bits::popLowestBit(horizontal));
+  }
+  uint64_t vertical = walls.verticalWalls();
+  while (vertical != 0) {
+    _touchedCorners |= geometry.verticalWallCorners(Bits::popLowestBit(vertical));
+  }
+}
+
+void WallCutFilter::addEdge(int from, int direction) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  switch (direction) {
+  case UP:
+    _routeDown.set(geometry.neighbour(from, UP));
+    break;
+  case DOWN:
+    _routeDown.set(from);
+    break;
+  case LEFT:
+    _routeRight.set(geometry.neighbour(from, LEFT));
+    break;
+  case RIGHT:
+    _routeRight.set(from);
+    break;
+  }
+}
+
+void WallCutFilter::addRoute(const WallsState& walls, const GoalDistances& distances, Player player, int cell) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  int distance = distances.distance(player, cell);
+  if (distance == GoalDistances::UNREACHABLE) {
+    return;
+  }
+  while (distance > 0) {
+    const uint8_t open = walls.openDirections(cell);
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(cell, direction);
+        if (distances.distance(player, next) == distance - 1) {
+          addEdge(cell, direction);
+          cell = next;
+          break;
+        }
+      }
+    }
+    --distance;
+  }
+}
+
+void WallCutFilter::addRoute(const MovementMasks& masks, const WallsState& walls, int cell, const CellMask& goal) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  CellMask layers[CELL_COUNT];
+  layers[0] = CellMask::cell(cell);
+  CellMask reached = layers[0];
+  int last = 0;
+  while ((layers[last] & goal).empty()) {
+    const CellMask next = masks.step(layers[last]) & ~reached;
+    if (next.empty()) {
+      return;
+    }
+    reached |= next;
+    layers[++last] = next;
+  }
+
+  CellMask arrived = layers[last] & goal;
+  int current = arrived.popLowestCell();
+  for (int layer = last; layer > 0; --layer) {
+    const uint8_t open = walls.openDirections(current);
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      if (open & directionBit(direction)) {
+        const int next = geometry.neighbour(current, direction);
+        if (layers[layer - 1].test(next)) {
+          addEdge(current, direction);
+          current = next;
+          break;
+        }
+      }
+    }
+  }
+}
+
+bool WallCutFilter::mayDisconnect(int center, MoveType type) const {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  if (type == PLACE_VERTICAL_WALL) {
+    return (geometry.verticalWallCorners(center) & _touchedCorners).count() >= 2
+        && (geometry.verticalWallCells(center) & _routeRight).any();
+  }
+  return (geometry.horizontalWallCorners(center) & _touchedCorners).count() >= 2
+      && (geometry.horizontalWallCells(center) & _routeDown).any();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Promising Walls
+//////////////////////////////////////////////////////////////////////////
+
+PromisingWalls Quoridor::promisingWalls(const WallsState& walls, const GoalDistances& distances, Player player,
+  int playerCell, int opponentCell) {
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  PromisingWalls promising = { 0, 0 };
+
+  // Every edge of every shortest route, walked a layer at a time down the opponent's distances.
+  const Player opponent = opponentOf(player);
+  int distance = distances.distance(opponent, opponentCell);
+  if (distance != GoalDistances::UNREACHABLE) {
+    CellMask layer = CellMask::cell(opponentCell);
+    for (; distance > 0; --distance) {
+      CellMask next;
+      while (layer.any()) {
+        const int cell = layer.popLowestCell();
+        const uint8_t open = walls.openDirections(cell);
+        for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+          if ((open & directionBit(direction)) == 0) {
+            continue;
+          }
+          const int neighbour = geometry.neighbour(cell, direction);
+          if (distances.distance(opponent, neighbour) == distance - 1) {
+            next.set(neighbour);
+            uint64_t& centers = (direction == UP || direction == DOWN) ? promising.horizontal : promising.vertical;
+            centers |= geometry.edgeBlockers(cell, direction);
+          }
+        }
+      }
+      layer = next;
+    }
+  }
+
+  // Any wall touching a pawn's square blocks one of its edges, whichever orientation it has.
+  for (int cell : { playerCell, opponentCell }) {
+    uint64_t around = 0;
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      around |= geometry.edgeBlockers(cell, direction);
+    }
+    promising.horizontal |= around;
+    promising.vertical |= around;
+  }
+
+  CellMask wallCorners;
+  uint64_t horizontal = walls.horizontalWalls();
+  while (horizontal != 0) {
+    wallCorners |= geometry.horizontalWallCorners(Bits::popLowestBit(horizontal));
+  }
+  uint64_t vertical = walls.verticalWalls();
+  while (vertical != 0) {
+    wallCorners |= geometry.verticalWallCorners(Bits::popLowestBit(vertical));
+  }
+  if (wallCorners.any()) {
+    for (int center = 0; center < WALL_CENTER_COUNT; ++center) {
+      if ((geometry.horizontalWallCorners(center) & wallCorners).any()) {
+        promising.horizontal |= 1ULL << center;
+      }
+      if ((geometry.verticalWallCorners(center) & wallCorners).any()) {
+        promising.vertical |= 1ULL << center;
+      }
+    }
+  }
+  return promising;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Board.hpp"
+#include "BoardGeometry.hpp"
+#include "CellMask.hpp"
+#include "VariantGeometry.hpp"
+
+namespace Quoridor {
+
+  // VariantMovement for the standard board, built from the walls of a game.
+  class MovementMasks : public VariantMovement<BOARD_SIZE> {
+  public:
+    explicit MovementMasks(const WallsState& walls)
+      : VariantMovement<BOARD_SIZE>(walls.horizontalWalls(), walls.verticalWalls())
+    { }
+  };
+
+  // Conservative test for whether a wall could possibly cut a pawn off from its goal row, so that
+  // only a handful of candidates need a real flood fill.
+  //
+  // A wall can only split the board if it closes a loop with the border and other walls, which means
+  // touching them at two or more corners. It also only matters to a pawn if it cuts an edge shared by
+  // every one of that pawn's routes, and any such edge lies on whichever single route we pick. A wall
+  // failing either test cannot disconnect anything.
+  class WallCutFilter {
+  public:
+    explicit WallCutFilter(const WallsState& walls);
+
+    // Adds a shortest route for a pawn, found by following the goal distances downhill.
+    void addRoute(const WallsState& walls, const GoalDistances& distances, Player player, int cell);
+    // Adds a shortest route for a pawn, found with a layered flood fill when no distances are kept.
+    void addRoute(const MovementMasks& masks, const WallsState& walls, int cell, const CellMask& goal);
+
+    bool mayDisconnect(int center, MoveType type) const;
+  private:
+    void addEdge(int from, int direction);
+
+    CellMask _touchedCorners;
+    // Squares whose bottom or right edge is on one of the routes.
+    CellMask _routeDown;
+    CellMask _routeRight;
+  };
+
+  // Wall centers worth trying before the rest, one mask per orientation: walls crossing any shortest
+  // route of the opponent, walls touching either pawn's square, and walls that would extend a wall
+  // already on the board. Together these are usually a small fraction of the legal walls and hold
+  // nearly all of the useful ones.
+  struct PromisingWalls {
+    uint64_t horizontal;
+    uint64_t vertical;
+  };
+
+  PromisingWalls promisingWalls(const WallsState& walls, const GoalDistances& distances, Player player,
+    int playerCell, int opponentCell);
+}
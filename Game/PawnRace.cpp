@@ -0,0 +1,256 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "BoardGeometry.hpp"
+#include "PawnRace.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+static const size_t CACHED_TABLES = 4;
+static const int STATE_COUNT = 2 * CELL_COUNT * CELL_COUNT;
+// Table values: zero for a position neither side can win, plies + 1 for a win and -(plies + 1) for
+// a loss, so a loss in no plies (the game is over) is still told apart.
+static const int16_t UNRESOLVED = 0;
+
+static inline int stateIndex(Player toMove, int playerOneCell, int playerTwoCell) {
+  return (toMove * CELL_COUNT + playerOneCell) * CELL_COUNT + playerTwoCell;
+}
+
+static inline int destination(const Move& move, int cell) {
+  return move.type == MOVE_PIECE
+    ? BoardGeometry::instance().neighbour(cell, move.info.pieceMoveDirection)
+    : cellIndex(move.info.jumpDestination);
+}
+
+static inline bool isOver(int playerOneCell, int playerTwoCell) {
+  return playerOneCell / BOARD_SIZE == BOARD_SIZE - 1 || playerTwoCell / BOARD_SIZE == 0;
+}
+
+// The state after the side to move goes to the given square.
+static inline int successor(Player toMove, int playerOneCell, int playerTwoCell, int to) {
+  return toMove == PLAYER_ONE
+    ? stateIndex(PLAYER_TWO, to, playerTwoCell)
+    : stateIndex(PLAYER_ONE, playerOneCell, to);
+}
+
+PawnRaceSolver::PawnRaceSolver()
+  : _nextTable(0)
+  , _tablesBuilt(0)
+{ }
+
+boost::optional<RaceOutcome> PawnRaceSolver::solve(const Board& board) {
+  const Player toMove = board.currentPlayer();
+  if (board.wallCount(toMove) != 0 || board.winner()) {
+    return boost::none;
+  }
+  const bool opponentHasWalls = board.wallCount(opponentOf(toMove)) != 0;
+
+  const Table* cached = findTable(board.wallsState());
+  if (opponentHasWalls && cached == nullptr) {
+    return outrun(board);
+  }
+  const Table& table = cached != nullptr ? *cached : tableFor(board.wallsState());
+  const int playerOneCell = cellIndex(board.playerPosition(PLAYER_ONE));
+  const int playerTwoCell = cellIndex(board.playerPosition(PLAYER_TWO));
+  const int16_t value = table.values[stateIndex(toMove, playerOneCell, playerTwoCell)];
+  if (opponentHasWalls && value >= 0) {
+    return boost::none;
+  }
+
+  RaceOutcome outcome;
+  outcome.plies = value == UNRESOLVED ? 0 : abs(value) - 1;
+  outcome.exact = !opponentHasWalls;
+  if (value > 0) {
+    outcome.winner = toMove;
+  }
+  else if (value < 0) {
+    outcome.winner = opponentOf(toMove);
+  }
+
+  // Quickest win, longest loss, or any move that keeps the draw.
+  const int cell = toMove == PLAYER_ONE ? playerOneCell : playerTwoCell;
+  MoveList moves;
+  board.availablePieceMovesForPlayer(toMove, moves);
+  int16_t bestValue = 0;
+  for (const Move& move : moves) {
+    const int16_t next = table.values[successor(toMove, playerOneCell, playerTwoCell, destination(move, cell))];
+    bool better;
+    if (value > 0) {
+      better = next < 0 && (!outcome.bestMove || next > bestValue);
+    }
+    else if (value < 0) {
+      better = !outcome.bestMove || next > bestValue;
+    }
+    else {
+      better = next == UNRESOLVED && !outcome.bestMove;
+    }
+    if (better) {
+      outcome.bestMove = move;
+      bestValue = next;
+    }
+  }
+  return outcome;
+}
+
+boost::optional<RaceOutcome> PawnRaceSolver::outrun(const Board& board) const {
+  const Player toMove = board.currentPlayer();
+  const Player opponent = opponentOf(toMove);
+  const WallsState& walls = board.wallsState();
+  const boost::optional<GoalDistances> computed = board.hasGoalDistances()
+    ? boost::none : boost::make_optional(GoalDistances(walls));
+  const GoalDistances& distances = computed ? *computed : board.goalDistances();
+  const int cell = cellIndex(board.playerPosition(toMove));
+  const int opponentCell = cellIndex(board.playerPosition(opponent));
+  const int opponentDistance = distances.distance(opponent, opponentCell);
+  if (opponentDistance >= distances.distance(toMove, cell)) {
+    return boost::none;
+  }
+
+  // The side to move has made opponentDistance moves and the opponent one fewer by the time the
+  // opponent steps home. Pawns further apart than that never stand next to each other, so there is
+  // no jump or block and the opponent's shortest route stands.
+  const int horizon = 2 * opponentDistance;
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  uint8_t steps[CELL_COUNT];
+  fill(begin(steps), end(steps), GoalDistances::UNREACHABLE);
+  int8_t queue[CELL_COUNT];
+  int head = 0;
+  int tail = 0;
+  steps[cell] = 0;
+  queue[tail++] = static_cast<int8_t>(cell);
+  while (head < tail) {
+    const int current = queue[head++];
+    if (current == opponentCell) {
+      return boost::none;
+    }
+    if (steps[current] == horizon) {
+      continue;
+    }
+    const uint8_t open = walls.openDirections(current);
+    for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+      const int next = geometry.neighbour(current, direction);
+      if ((open & directionBit(direction)) && steps[next] == GoalDistances::UNREACHABLE) {
+        steps[next] = static_cast<uint8_t>(steps[current] + 1);
+        queue[tail++] = static_cast<int8_t>(next);
+      }
+    }
+  }
+
+  RaceOutcome outcome;
+  outcome.winner = opponent;
+  outcome.plies = 2 * opponentDistance;
+  // The opponent's shortest route is all there is to it, walls or no walls.
+  outcome.exact = true;
+  // Nothing changes the result, so any move will do; a step toward goal keeps the game sensible.
+  MoveList moves;
+  board.availablePieceMovesForPlayer(toMove, moves);
+  for (const Move& move : moves) {
+    if (!outcome.bestMove || distances.distance(toMove, destination(move, cell)) < distances.distance(toMove, cell)) {
+      outcome.bestMove = move;
+    }
+  }
+  return outcome;
+}
+
+const PawnRaceSolver::Table* PawnRaceSolver::findTable(const WallsState& walls) const {
+  for (const Table& table : _tables) {
+    if (table.horizontal == walls.horizontalWalls() && table.vertical == walls.verticalWalls()) {
+      return &table;
+    }
+  }
+  return nullptr;
+}
+
+const PawnRaceSolver::Table& PawnRaceSolver::tableFor(const WallsState& walls) {
+  const Table* cached = findTable(walls);
+  if (cached != nullptr) {
+    return *cached;
+  }
+  if (_tables.size() < CACHED_TABLES) {
+    _tables.emplace_back();
+    _nextTable = _tables.size() - 1;
+  }
+  Table& table = _tables[_nextTable];
+  _nextTable = (_nextTable + 1) % CACHED_TABLES;
+  table.horizontal = walls.horizontalWalls();
+  table.vertical = walls.verticalWalls();
+  build(table, walls);
+  ++_tablesBuilt;
+  return table;
+}
+
+void PawnRaceSolver::build(Table& table, const WallsState& walls) const {
+  table.values.assign(STATE_COUNT, UNRESOLVED);
+
+  // Every state's successors, and from them the reverse edges, in compressed row form.
+  vector<int> successors;
+  vector<int> successorStart(STATE_COUNT + 1, 0);
+  vector<uint8_t> unresolvedSuccessors(STATE_COUNT, 0);
+  vector<int> queue;
+  queue.reserve(STATE_COUNT);
+  successors.reserve(STATE_COUNT * MAX_PIECE_MOVES);
+  for (int state = 0; state < STATE_COUNT; ++state) {
+    successorStart[state] = static_cast<int>(successors.size());
+    const Player toMove = static_cast<Player>(state / (CELL_COUNT * CELL_COUNT));
+    const int playerOneCell = (state / CELL_COUNT) % CELL_COUNT;
+    const int playerTwoCell = state % CELL_COUNT;
+    if (playerOneCell == playerTwoCell) {
+      continue;
+    }
+    if (isOver(playerOneCell, playerTwoCell)) {
+      // Whoever moved last has won.
+      table.values[state] = -1;
+      queue.push_back(state);
+      continue;
+    }
+    const int cell = toMove == PLAYER_ONE ? playerOneCell : playerTwoCell;
+    const int opponentCell = toMove == PLAYER_ONE ? playerTwoCell : playerOneCell;
+    MoveList moves;
+    walls.availablePieceMoves(toMove, cell, opponentCell, moves);
+    for (const Move& move : moves) {
+      successors.push_back(successor(toMove, playerOneCell, playerTwoCell, destination(move, cell)));
+    }
+    unresolvedSuccessors[state] = static_cast<uint8_t>(moves.size());
+  }
+  successorStart[STATE_COUNT] = static_cast<int>(successors.size());
+
+  vector<int> predecessorStart(STATE_COUNT + 1, 0);
+  for (int next : successors) {
+    ++predecessorStart[next + 1];
+  }
+  for (int state = 0; state < STATE_COUNT; ++state) {
+    predecessorStart[state + 1] += predecessorStart[state];
+  }
+  vector<int> predecessors(successors.size());
+  vector<int> fill(begin(predecessorStart), end(predecessorStart) - 1);
+  for (int state = 0; state < STATE_COUNT; ++state) {
+    for (int i = successorStart[state]; i < successorStart[state + 1]; ++i) {
+      predecessors[fill[successors[i]]++] = state;
+    }
+  }
+
+  // Breadth first from the finished games, so states resolve in order of plies. A state is won as
+  // soon as one move reaches a lost state, and lost once every move reaches a won state, the last
+  // of them being the longest the loser can hold out.
+  for (size_t head = 0; head < queue.size(); ++head) {
+    const int state = queue[head];
+    const int16_t value = table.values[state];
+    const int plies = abs(value) - 1;
+    for (int i = predecessorStart[state]; i < predecessorStart[state + 1]; ++i) {
+      const int previous = predecessors[i];
+      if (table.values[previous] != UNRESOLVED) {
+        continue;
+      }
+      if (value < 0) {
+        table.values[previous] = static_cast<int16_t>(plies + 2);
+        queue.push_back(previous);
+      }
+      else if (--unresolvedSuccessors[previous] == 0) {
+        table.values[previous] = static_cast<int16_t>(-(plies + 2));
+        queue.push_back(previous);
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "Board.hpp"
+
+namespace Quoridor {
+
+  // Game theoretic value of a position from the side to move's point of view.
+  struct RaceOutcome {
+    // Empty when neither side can force a win, so best play goes on forever.
+    boost::optional<Player> winner;
+    // Plies to the end with best play: the winner as quickly as possible, the loser holding out. Zero
+    // for a draw. When the winner still holds walls this is only an upper bound, since walls can cut
+    // the loser's defence short, and exact is false.
+    int plies;
+    bool exact;
+    boost::optional<Move> bestMove;
+  };
+
+  // Solves the pawn race that is left once the walls have run out. With the walls fixed only the two
+  // pawns and the side to move change, under 14 thousand states, so the whole race is solved at once
+  // by retrograde analysis and every later position with the same walls is a table lookup. That
+  // settles jumps, blocking and tempo exactly where distance counting can only guess.
+  //
+  // When only the side not to move still has walls the race still decides a loss for the side to
+  // move, since the opponent could simply race. A win or draw there is not certain. Those positions
+  // are not worth a table, since with walls still to come nearly every one has its own layout. They
+  // are answered from a table only if one is cached already, and otherwise only when the opponent is
+  // nearer goal and the pawns are too far apart to meet before the opponent gets there.
+  //
+  // Keeps the tables for the last few wall layouts. Not thread safe, each thread should own one.
+  class PawnRaceSolver {
+  public:
+    PawnRaceSolver();
+
+    // The outcome, or nothing when walls remain in play and decide it.
+    boost::optional<RaceOutcome> solve(const Board& board);
+
+    // Tables built over the solver's lifetime, each a retrograde pass over every race state.
+    inline uint64_t tablesBuilt() const {
+      return _tablesBuilt;
+    }
+  private:
+    // Per state: whether the side to move wins, loses or neither, and in how many plies.
+    struct Table {
+      uint64_t horizontal;
+      uint64_t vertical;
+      std::vector<int16_t> values;
+    };
+
+    boost::optional<RaceOutcome> outrun(const Board& board) const;
+    const Table* findTable(const WallsState& walls) const;
+    const Table& tableFor(const WallsState& walls);
+    void build(Table& table, const WallsState& walls) const;
+
+    std::vector<Table> _tables;
+    size_t _nextTable;
+    uint64_t _tablesBuilt;
+  };
+}
@@ -0,0 +1,498 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Retrograde.hpp"
+#include "Util/Bits.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+namespace Quoridor {
+  // Start of a table file. Layouts follow, sorted, and then the values packed 32 to a word.
+  struct RetrogradeHeader {
+    uint64_t magic;
+    uint32_t boardSize;
+    uint32_t startingWalls;
+    uint64_t layoutCount;
+    uint64_t stateCount;
+  };
+
+  // One wall layout, as the two wall words of the packed encoding, and where its states start.
+  struct RetrogradeLayout {
+    uint64_t occupiedCenters;
+    // One bit per occupied center in center order, set for vertical.
+    uint64_t orientations;
+    uint64_t firstState;
+  };
+}
+
+// "QRETRO01" read as a little endian word.
+static const uint64_t TABLE_MAGIC = 0x31304F5254455251ULL;
+static const int STATES_PER_WORD = 32;
+static const uint64_t VALUE_MASK = 0x3;
+
+static inline bool layoutBefore(const RetrogradeLayout& first, const RetrogradeLayout& second) {
+  return first.occupiedCenters != second.occupiedCenters
+    ? first.occupiedCenters < second.occupiedCenters
+    : first.orientations < second.orientations;
+}
+
+static inline int wallCountOf(const RetrogradeLayout& layout) {
+  return Bits::popCount(layout.occupiedCenters);
+}
+
+// Fewest walls player one can have placed when this many are on the board.
+static inline int firstSplit(int placed, int startingWalls) {
+  return max(0, placed - startingWalls);
+}
+
+static inline int splitCount(int placed, int startingWalls) {
+  return min(placed, startingWalls) - firstSplit(placed, startingWalls) + 1;
+}
+
+// States of one split, rounded up to whole words so threads solving different layouts never write
+// to the same word.
+static inline uint64_t blockStride(int cellCount) {
+  const uint64_t states = 2ULL * cellCount * cellCount;
+  return (states + STATES_PER_WORD - 1) / STATES_PER_WORD * STATES_PER_WORD;
+}
+
+static inline size_t tableBytes(uint64_t layoutCount, uint64_t stateCount) {
+  return static_cast<size_t>(sizeof(RetrogradeHeader) + layoutCount * sizeof(RetrogradeLayout)
+    + stateCount / STATES_PER_WORD * sizeof(uint64_t));
+}
+
+static inline uint64_t stateIndex(const RetrogradeLayout& layout, int cellCount, int startingWalls,
+  int playerOnePlaced, Player toMove, int playerOneCell, int playerTwoCell)
+{
+  const int split = playerOnePlaced - firstSplit(wallCountOf(layout), startingWalls);
+  return layout.firstState + split * blockStride(cellCount)
+    + (static_cast<uint64_t>(toMove) * cellCount + playerOneCell) * cellCount + playerTwoCell;
+}
+
+static inline GameValue readValue(const uint64_t* values, uint64_t state) {
+  return static_cast<GameValue>((values[state / STATES_PER_WORD] >> (state % STATES_PER_WORD * 2)) & VALUE_MASK);
+}
+
+static const RetrogradeLayout* findLayout(const RetrogradeLayout* first, const RetrogradeLayout* last,
+  uint64_t horizontal, uint64_t vertical)
+{
+  const uint64_t occupied = horizontal | vertical;
+  const RetrogradeLayout key = { occupied, Bits::extract(vertical, occupied), 0 };
+  const RetrogradeLayout* found = lower_bound(first, last, key, layoutBefore);
+  if (found == last || found->occupiedCenters != key.occupiedCenters || found->orientations != key.orientations) {
+    return nullptr;
+  }
+  return found;
+}
+
+RetrogradeTable::RetrogradeTable()
+  : _header(nullptr)
+  , _layouts(nullptr)
+  , _values(nullptr)
+{ }
+
+bool RetrogradeTable::open(const string& path) {
+  _header = nullptr;
+  _layouts = nullptr;
+  _values = nullptr;
+  if (!_file.open(path)) {
+    return false;
+  }
+  const RetrogradeHeader* header = reinterpret_cast<const RetrogradeHeader*>(_file.data());
+  if (_file.size() < sizeof(RetrogradeHeader) || header->magic != TABLE_MAGIC
+    || header->stateCount % STATES_PER_WORD != 0 || _file.size() != tableBytes(header->layoutCount, header->stateCount))
+  {
+    _file.close();
+    return false;
+  }
+  _header = header;
+  _layouts = reinterpret_cast<const RetrogradeLayout*>(_file.data() + sizeof(RetrogradeHeader));
+  _values = reinterpret_cast<const uint64_t*>(_layouts + header->layoutCount);
+  return true;
+}
+
+int RetrogradeTable::boardSize() const {
+  ARC_ASSERT(_header != nullptr);
+  return static_cast<int>(_header->boardSize);
+}
+
+int RetrogradeTable::startingWalls() const {
+  ARC_ASSERT(_header != nullptr);
+  return static_cast<int>(_header->startingWalls);
+}
+
+uint64_t RetrogradeTable::layoutCount() const {
+  ARC_ASSERT(_header != nullptr);
+  return _header->layoutCount;
+}
+
+uint64_t RetrogradeTable::stateCount() const {
+  ARC_ASSERT(_header != nullptr);
+  return _header->stateCount;
+}
+
+GameValue RetrogradeTable::value(uint64_t horizontal, uint64_t vertical, int playerOneCell, int playerTwoCell,
+  int playerOneWalls, int playerTwoWalls, Player toMove) const
+{
+  ARC_ASSERT(_header != nullptr);
+  const int cellCount = boardSize() * boardSize();
+  const int walls = startingWalls();
+  if ((horizontal & vertical) != 0 || playerOneCell < 0 || playerOneCell >= cellCount
+    || playerTwoCell < 0 || playerTwoCell >= cellCount || playerOneWalls < 0 || playerOneWalls > walls
+    || playerTwoWalls < 0 || playerTwoWalls > walls)
+  {
+    return VALUE_UNREACHABLE;
+  }
+  const int playerOnePlaced = walls - playerOneWalls;
+  if (playerOnePlaced + walls - playerTwoWalls != Bits::popCount(horizontal | vertical)) {
+    return VALUE_UNREACHABLE;
+  }
+  const RetrogradeLayout* layout = findLayout(_layouts, _layouts + _header->layoutCount, horizontal, vertical);
+  if (layout == nullptr) {
+    return VALUE_UNREACHABLE;
+  }
+  return readValue(_values, stateIndex(*layout, cellCount, walls, playerOnePlaced, toMove, playerOneCell, playerTwoCell));
+}
+
+// Every layout of at most the given number of walls in which no two walls overlap or cross, centers
+// taken in order. Walls that only touch end to end are legal and included.
+template <int SIZE>
+static void addLayouts(vector<RetrogradeLayout>& layouts, int center, uint64_t horizontal, uint64_t vertical, int wallsLeft) {
+  if (center == Variant<SIZE, 0>::WALL_CENTER_COUNT) {
+    const uint64_t occupied = horizontal | vertical;
+    layouts.push_back({ occupied, Bits::extract(vertical, occupied), 0 });
+    return;
+  }
+  addLayouts<SIZE>(layouts, center + 1, horizontal, vertical, wallsLeft);
+  if (wallsLeft == 0) {
+    return;
+  }
+  const uint64_t bit = 1ULL << center;
+  if (VariantRules<SIZE>::availableHorizontalCenters(horizontal, vertical) & bit) {
+    addLayouts<SIZE>(layouts, center + 1, horizontal | bit, vertical, wallsLeft - 1);
+  }
+  if (VariantRules<SIZE>::availableVerticalCenters(horizontal, vertical) & bit) {
+    addLayouts<SIZE>(layouts, center + 1, horizontal, vertical | bit, wallsLeft - 1);
+  }
+}
+
+namespace {
+  // A wall that can be added to a layout, legal wherever both pawns stand on squares still joined to
+  // their goals once it is up.
+  struct WallOption {
+    uint64_t reachOne;
+    uint64_t reachTwo;
+    const RetrogradeLayout* next;
+  };
+
+  // Solves layouts one at a time, keeping its buffers between them. One per thread.
+  template <int SIZE, int WALLS>
+  class LayoutSolver {
+  public:
+    typedef VariantBoard<SIZE, WALLS> BoardType;
+    typedef VariantGeometry<SIZE> Geometry;
+    typedef VariantRules<SIZE> Rules;
+    static const int CELL_COUNT = SIZE * SIZE;
+    static const int STATE_COUNT = 2 * CELL_COUNT * CELL_COUNT;
+
+    LayoutSolver(const vector<RetrogradeLayout>& layouts, uint64_t* table)
+      : wins(0)
+      , losses(0)
+      , draws(0)
+      , unreachable(0)
+      , _layouts(layouts)
+      , _table(table)
+      , _values(STATE_COUNT)
+      , _successorStart(STATE_COUNT + 1)
+      , _unresolvedSuccessors(STATE_COUNT)
+      , _escapes(STATE_COUNT)
+      , _predecessorStart(STATE_COUNT + 1)
+      , _fill(STATE_COUNT)
+    {
+      _successors.reserve(STATE_COUNT * MAX_PIECE_MOVES);
+      _predecessors.reserve(STATE_COUNT * MAX_PIECE_MOVES);
+      _queue.reserve(STATE_COUNT);
+    }
+
+    void solve(const RetrogradeLayout& layout) {
+      const uint64_t vertical = Bits::deposit(layout.orientations, layout.occupiedCenters);
+      const uint64_t horizontal = layout.occupiedCenters & ~vertical;
+      const int placed = wallCountOf(layout);
+
+      _options.clear();
+      if (placed < 2 * WALLS) {
+        uint64_t candidates = Rules::availableHorizontalCenters(horizontal, vertical);
+        while (candidates != 0) {
+          addOption(horizontal | (1ULL << Bits::popLowestBit(candidates)), vertical);
+        }
+        candidates = Rules::availableVerticalCenters(horizontal, vertical);
+        while (candidates != 0) {
+          addOption(horizontal, vertical | (1ULL << Bits::popLowestBit(candidates)));
+        }
+      }
+
+      const uint64_t reachOne = goalReach(PLAYER_ONE, horizontal, vertical);
+      const uint64_t reachTwo = goalReach(PLAYER_TWO, horizontal, vertical);
+      const int first = firstSplit(placed, WALLS);
+      for (int playerOnePlaced = first; playerOnePlaced < first + splitCount(placed, WALLS); ++playerOnePlaced) {
+        solveSplit(layout, horizontal, vertical, playerOnePlaced, reachOne, reachTwo);
+      }
+    }
+
+    uint64_t wins;
+    uint64_t losses;
+    uint64_t draws;
+    uint64_t unreachable;
+  private:
+    static inline int localIndex(Player toMove, int playerOneCell, int playerTwoCell) {
+      return (toMove * CELL_COUNT + playerOneCell) * CELL_COUNT + playerTwoCell;
+    }
+
+    // Squares joined to the player's goal row. Steps are open both ways, so that is everywhere the
+    // player could still get home from.
+    static uint64_t goalReach(Player player, uint64_t horizontal, uint64_t vertical) {
+      static_assert(CELL_COUNT <= 64, "Reach is kept as a 64 bit mask");
+      const VariantMovement<SIZE> movement(horizontal, vertical);
+      return movement.floodFill(VariantCells<SIZE>::goalCells(player), CellMask()).low();
+    }
+
+    void addOption(uint64_t horizontal, uint64_t vertical) {
+      const WallOption option = {
+        goalReach(PLAYER_ONE, horizontal, vertical),
+        goalReach(PLAYER_TWO, horizontal, vertical),
+        findLayout(_layouts.data(), _layouts.data() + _layouts.size(), horizontal, vertical)
+      };
+      ARC_ASSERT(option.next != nullptr);
+      _options.push_back(option);
+    }
+
+    void solveSplit(const RetrogradeLayout& layout, uint64_t horizontal, uint64_t vertical, int playerOnePlaced,
+      uint64_t reachOne, uint64_t reachTwo)
+    {
+      const int walls[2] = { WALLS - playerOnePlaced, WALLS - (wallCountOf(layout) - playerOnePlaced) };
+      fill(_values.begin(), _values.end(), VALUE_DRAW);
+      fill(_escapes.begin(), _escapes.end(), false);
+      _successors.clear();
+      _queue.clear();
+
+      typename BoardType::MoveList moves;
+      for (int state = 0; state < STATE_COUNT; ++state) {
+        _successorStart[state] = static_cast<int>(_successors.size());
+        _unresolvedSuccessors[state] = 0;
+        const Player toMove = static_cast<Player>(state / (CELL_COUNT * CELL_COUNT));
+        const int playerOneCell = (state / CELL_COUNT) % CELL_COUNT;
+        const int playerTwoCell = state % CELL_COUNT;
+        if (playerOneCell == playerTwoCell || (reachOne & (1ULL << playerOneCell)) == 0
+          || (reachTwo & (1ULL << playerTwoCell)) == 0)
+        {
+          _values[state] = VALUE_UNREACHABLE;
+          continue;
+        }
+        const bool oneHome = playerOneCell / SIZE == SIZE - 1;
+        const bool twoHome = playerTwoCell / SIZE == 0;
+        if (oneHome || twoHome) {
+          // Whoever moved last has won, and the game stops there.
+          const bool lastMoverWon = toMove == PLAYER_ONE ? twoHome && !oneHome : oneHome && !twoHome;
+          _values[state] = lastMoverWon ? VALUE_LOSS : VALUE_UNREACHABLE;
+          if (lastMoverWon) {
+            _queue.push_back(state);
+          }
+          continue;
+        }
+
+        const BoardType board(playerOneCell, playerTwoCell, walls[PLAYER_ONE], walls[PLAYER_TWO], horizontal, vertical, toMove);
+        moves.clear();
+        board.availablePieceMoves(moves);
+        const int cell = board.playerCell(toMove);
+        for (const Move& move : moves) {
+          const int to = move.type == MOVE_PIECE
+            ? Geometry::neighbour(cell, move.info.pieceMoveDirection)
+            : BoardType::cellOf(move.info.jumpDestination);
+          _successors.push_back(toMove == PLAYER_ONE
+            ? localIndex(PLAYER_TWO, to, playerTwoCell)
+            : localIndex(PLAYER_ONE, playerOneCell, to));
+        }
+        _unresolvedSuccessors[state] = static_cast<uint8_t>(moves.size());
+
+        // Walls lead to fuller layouts, which are solved already.
+        bool winningWall = false;
+        int wallMoves = 0;
+        if (walls[toMove] > 0) {
+          const int nextPlayerOnePlaced = playerOnePlaced + (toMove == PLAYER_ONE ? 1 : 0);
+          for (const WallOption& option : _options) {
+            if ((option.reachOne & (1ULL << playerOneCell)) == 0 || (option.reachTwo & (1ULL << playerTwoCell)) == 0) {
+              continue;
+            }
+            ++wallMoves;
+            const GameValue next = readValue(_table, stateIndex(*option.next, CELL_COUNT, WALLS, nextPlayerOnePlaced,
+              opponentOf(toMove), playerOneCell, playerTwoCell));
+            ARC_ASSERT(next != VALUE_UNREACHABLE);
+            winningWall |= next == VALUE_LOSS;
+            _escapes[state] = _escapes[state] || next == VALUE_DRAW;
+          }
+        }
+        if (winningWall) {
+          _values[state] = VALUE_WIN;
+          _queue.push_back(state);
+        }
+        else if (moves.empty() && wallMoves > 0 && !_escapes[state]) {
+          // Every move is a wall, and every wall loses.
+          _values[state] = VALUE_LOSS;
+          _queue.push_back(state);
+        }
+      }
+      _successorStart[STATE_COUNT] = static_cast<int>(_successors.size());
+
+      fill(_predecessorStart.begin(), _predecessorStart.end(), 0);
+      for (int next : _successors) {
+        ++_predecessorStart[next + 1];
+      }
+      for (int state = 0; state < STATE_COUNT; ++state) {
+        _predecessorStart[state + 1] += _predecessorStart[state];
+      }
+      _predecessors.resize(_successors.size());
+      copy(_predecessorStart.begin(), _predecessorStart.end() - 1, _fill.begin());
+      for (int state = 0; state < STATE_COUNT; ++state) {
+        for (int i = _successorStart[state]; i < _successorStart[state + 1]; ++i) {
+          _predecessors[_fill[_successors[i]]++] = state;
+        }
+      }
+
+      // A state is won once one pawn move reaches a lost state, and lost once every pawn move reaches a
+      // won state with no wall to fall back on. Whatever is left can be held forever.
+      for (size_t head = 0; head < _queue.size(); ++head) {
+        const int state = _queue[head];
+        const bool lost = _values[state] == VALUE_LOSS;
+        for (int i = _predecessorStart[state]; i < _predecessorStart[state + 1]; ++i) {
+          const int previous = _predecessors[i];
+          if (_values[previous] != VALUE_DRAW) {
+            continue;
+          }
+          if (lost) {
+            _values[previous] = VALUE_WIN;
+            _queue.push_back(previous);
+          }
+          else if (--_unresolvedSuccessors[previous] == 0 && !_escapes[previous]) {
+            _values[previous] = VALUE_LOSS;
+            _queue.push_back(previous);
+          }
+        }
+      }
+
+      const uint64_t first = stateIndex(layout, CELL_COUNT, WALLS, playerOnePlaced, PLAYER_ONE, 0, 0);
+      uint64_t* words = _table + first / STATES_PER_WORD;
+      for (int start = 0; start < STATE_COUNT; start += STATES_PER_WORD) {
+        uint64_t word = 0;
+        for (int i = 0; i < STATES_PER_WORD && start + i < STATE_COUNT; ++i) {
+          word |= static_cast<uint64_t>(_values[start + i]) << (i * 2);
+        }
+        words[start / STATES_PER_WORD] = word;
+      }
+      for (uint8_t value : _values) {
+        wins += value == VALUE_WIN;
+        losses += value == VALUE_LOSS;
+        draws += value == VALUE_DRAW;
+        unreachable += value == VALUE_UNREACHABLE;
+      }
+    }
+
+    const vector<RetrogradeLayout>& _layouts;
+    uint64_t* _table;
+    vector<WallOption> _options;
+    vector<uint8_t> _values;
+    vector<int> _successors;
+    vector<int> _successorStart;
+    vector<uint8_t> _unresolvedSuccessors;
+    vector<bool> _escapes;
+    vector<int> _predecessorStart;
+    vector<int> _predecessors;
+    vector<int> _fill;
+    vector<int> _queue;
+  };
+}
+
+template <int SIZE, int WALLS>
+RetrogradeSolver<SIZE, WALLS>::RetrogradeSolver(int threadCount)
+  : _threadCount(threadCount > 0 ? threadCount : max(1, static_cast<int>(thread::hardware_concurrency())))
+{ }
+
+template <int SIZE, int WALLS>
+boost::optional<RetrogradeStats> RetrogradeSolver<SIZE, WALLS>::solve(const string& path) const {
+  static_assert(SIZE * SIZE <= 64, "Squares joined to a goal are kept in a 64 bit mask");
+  typedef LayoutSolver<SIZE, WALLS> Solver;
+  const auto start = chrono::steady_clock::now();
+
+  vector<RetrogradeLayout> layouts;
+  addLayouts<SIZE>(layouts, 0, 0, 0, 2 * WALLS);
+  sort(layouts.begin(), layouts.end(), layoutBefore);
+  vector<vector<const RetrogradeLayout*>> byWallCount(2 * WALLS + 1);
+  uint64_t stateCount = 0;
+  for (RetrogradeLayout& layout : layouts) {
+    const int placed = wallCountOf(layout);
+    layout.firstState = stateCount;
+    stateCount += splitCount(placed, WALLS) * blockStride(Solver::CELL_COUNT);
+    byWallCount[placed].push_back(&layout);
+  }
+
+  MappedFile file;
+  if (!file.create(path, tableBytes(layouts.size(), stateCount))) {
+    return boost::none;
+  }
+  const RetrogradeHeader header = { TABLE_MAGIC, SIZE, WALLS, layouts.size(), stateCount };
+  memcpy(file.data(), &header, sizeof(header));
+  memcpy(file.data() + sizeof(header), layouts.data(), layouts.size() * sizeof(RetrogradeLayout));
+  uint64_t* table = reinterpret_cast<uint64_t*>(file.data() + sizeof(header) + layouts.size() * sizeof(RetrogradeLayout));
+
+  vector<unique_ptr<Solver>> solvers;
+  for (int i = 0; i < _threadCount; ++i) {
+    solvers.emplace_back(new Solver(layouts, table));
+  }
+  // Layouts with the same number of walls only read fuller ones, so each level is shared out freely.
+  for (int placed = 2 * WALLS; placed >= 0; --placed) {
+    const vector<const RetrogradeLayout*>& level = byWallCount[placed];
+    atomic<size_t> next(0);
+    auto work = [&level, &next](Solver* solver) {
+      for (size_t i = next++; i < level.size(); i = next++) {
+        solver->solve(*level[i]);
+      }
+    };
+    vector<thread> helpers;
+    for (size_t i = 1; i < min(solvers.size(), level.size()); ++i) {
+      helpers.emplace_back(work, solvers[i].get());
+    }
+    work(solvers[0].get());
+    for (thread& helper : helpers) {
+      helper.join();
+    }
+  }
+  file.flush();
+
+  RetrogradeStats stats = {};
+  stats.layouts = layouts.size();
+  for (const auto& solver : solvers) {
+    stats.wins += solver->wins;
+    stats.losses += solver->losses;
+    stats.draws += solver->draws;
+    stats.unreachable += solver->unreachable;
+  }
+  // The padding at the end of each split is not a position.
+  stats.states = stats.wins + stats.losses + stats.draws + stats.unreachable;
+  stats.fileBytes = file.size();
+  stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  stats.statesPerSecond = stats.seconds > 0 ? stats.states / stats.seconds : 0;
+  return stats;
+}
+
+template class Quoridor::RetrogradeSolver<3, 1>;
+template class Quoridor::RetrogradeSolver<3, 2>;
+template class Quoridor::RetrogradeSolver<5, 1>;
+template class Quoridor::RetrogradeSolver<5, 2>;
+template class Quoridor::RetrogradeSolver<5, 3>;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.hpp"
+#include "VariantBoard.hpp"
+#include "Util/Arc_Assert.hpp"
+
+namespace Quoridor {
+
+  // Game theoretic value of a position for the side to move, stored in two bits.
+  enum GameValue : uint8_t {
+    // Neither side can force a win. Also what every position reads as before it is solved.
+    VALUE_DRAW = 0,
+    VALUE_WIN = 1,
+    VALUE_LOSS = 2,
+    // No game gets here: both pawns on one square, a pawn walled off from its goal, or the winner to
+    // move again.
+    VALUE_UNREACHABLE = 3
+  };
+
+  struct RetrogradeStats {
+    uint64_t layouts;
+    uint64_t states;
+    uint64_t wins;
+    uint64_t losses;
+    uint64_t draws;
+    uint64_t unreachable;
+    size_t fileBytes;
+    double seconds;
+    double statesPerSecond;
+  };
+
+  struct RetrogradeHeader;
+  struct RetrogradeLayout;
+
+  // A solved variant mapped from the file RetrogradeSolver wrote. Lookups touch only the pages they
+  // need, so even tables of hundreds of megabytes open instantly.
+  class RetrogradeTable {
+  public:
+    RetrogradeTable();
+
+    // False when the file is missing or is not a table.
+    bool open(const std::string& path);
+
+    int boardSize() const;
+    int startingWalls() const;
+    uint64_t layoutCount() const;
+    uint64_t stateCount() const;
+
+    // VALUE_UNREACHABLE for positions no game of the variant reaches, such as wall counts that do not
+    // add up to the walls on the board.
+    GameValue value(uint64_t horizontal, uint64_t vertical, int playerOneCell, int playerTwoCell,
+      int playerOneWalls, int playerTwoWalls, Player toMove) const;
+
+    template <int SIZE, int WALLS>
+    GameValue value(const VariantBoard<SIZE, WALLS>& board) const {
+      ARC_ASSERT(boardSize() == SIZE && startingWalls() == WALLS);
+      return value(board.horizontalWalls(), board.verticalWalls(), board.playerCell(PLAYER_ONE),
+        board.playerCell(PLAYER_TWO), board.wallCount(PLAYER_ONE), board.wallCount(PLAYER_TWO), board.currentPlayer());
+    }
+  private:
+    MappedFile _file;
+    const RetrogradeHeader* _header;
+    const RetrogradeLayout* _layouts;
+    const uint64_t* _values;
+  };
+
+  // Solves every position of a small variant and writes the values to a mapped file, two bits each.
+  //
+  // States are numbered in the order of the packed board encoding: first the wall layout, by its
+  // occupied centers and then their orientations, then the split of the placed walls between the
+  // players, the side to move and the two pawn squares. Walls are never taken back, so a layout's
+  // positions depend only on their own pawn moves and on layouts with one wall more. Layouts are
+  // solved from the fullest down, those with the same number of walls spread over all threads, and
+  // within a layout the pawn moves are resolved backwards from the finished games as in
+  // PawnRaceSolver.
+  //
+  // Instantiated for 3x3 and 5x5 boards with one to three walls each; 5x5 with three walls is about
+  // 570 million positions in a 150 megabyte file.
+  template <int SIZE, int WALLS>
+  class RetrogradeSolver {
+  public:
+    // Zero threads means one per core.
+    explicit RetrogradeSolver(int threadCount = 0);
+
+    // Nothing when the file could not be created.
+    boost::optional<RetrogradeStats> solve(const std::string& path) const;
+  private:
+    int _threadCount;
+  };
+}
@@ -0,0 +1,131 @@
+#include "pch.h"
+
+#include "BoardGeometry.hpp"
+#include "Evaluation.hpp"
+#include "Rollout.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+static const float DEFAULT_WALL_PROBABILITY = 0.1f;
+static const float DEFAULT_RANDOM_STEP_PROBABILITY = 0.05f;
+
+RolloutPolicy::RolloutPolicy(uint64_t seed)
+  : _random(seed)
+  , _wallProbability(DEFAULT_WALL_PROBABILITY)
+  , _randomStepProbability(DEFAULT_RANDOM_STEP_PROBABILITY)
+  , _pliesPlayed(0)
+{
+  _undos.reserve(DEFAULT_ROLLOUT_PLIES);
+}
+
+RolloutResult RolloutPolicy::play(Board& board, int maxPlies) {
+  ARC_ASSERT(board.hasGoalDistances());
+  RolloutResult result;
+  result.winner = board.winner();
+  result.plies = 0;
+  result.evaluation = 0;
+  while (!result.winner && result.plies < maxPlies) {
+    _undos.push_back(board.doMove(chooseMove(board)));
+    ++result.plies;
+    result.winner = board.winner();
+  }
+  if (!result.winner) {
+    result.evaluation = result.plies % 2 == 0 ? evaluate(board) : -evaluate(board);
+  }
+  _pliesPlayed += result.plies;
+  while (!_undos.empty()) {
+    board.undoMove(_undos.back());
+    _undos.pop_back();
+  }
+  return result;
+}
+
+Move RolloutPolicy::chooseMove(const Board& board) {
+  const Player player = board.currentPlayer();
+  if (board.wallCount(player) > 0 && _random.unitFloat() < _wallProbability) {
+    const boost::optional<Move> wall = chooseWall(board);
+    if (wall) {
+      return *wall;
+    }
+  }
+
+  MoveList moves;
+  board.availablePieceMovesForPlayer(player, moves);
+  ARC_ASSERT(!moves.empty());
+  if (_random.unitFloat() < _randomStepProbability) {
+    return moves[_random.below(moves.size())];
+  }
+
+  // Reservoir sample among the moves landing closest to goal so ties are broken evenly.
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  const GoalDistances& distances = board.goalDistances();
+  const int cell = cellIndex(board.playerPosition(player));
+  int best = 0;
+  int bestDistance = GoalDistances::UNREACHABLE + 1;
+  int ties = 0;
+  for (int i = 0; i < moves.size(); ++i) {
+    const Move& move = moves[i];
+    const int destination = move.type == MOVE_PIECE
+      ? geometry.neighbour(cell, move.info.pieceMoveDirection)
+      : cellIndex(move.info.jumpDestination);
+    const int distance = distances.distance(player, destination);
+    if (distance < bestDistance) {
+      best = i;
+      bestDistance = distance;
+      ties = 1;
+    }
+    else if (distance == bestDistance && _random.below(++ties) == 0) {
+      best = i;
+    }
+  }
+  return moves[best];
+}
+
+boost::optional<Move> RolloutPolicy::chooseWall(const Board& board) {
+  // Block the first step of one of the opponent's shortest routes. Only open edges leading one closer
+  // to goal qualify, and each is blocked by at most two wall centers. Centers that would collide with
+  // a wall already there are dropped up front, so every candidate really cuts the edge.
+  const BoardGeometry& geometry = BoardGeometry::instance();
+  const GoalDistances& distances = board.goalDistances();
+  const WallsState& walls = board.wallsState();
+  const Player player = board.currentPlayer();
+  const Player opponent = opponentOf(player);
+  const int cell = cellIndex(board.playerPosition(opponent));
+  const int distance = distances.distance(opponent, cell);
+  const uint8_t open = walls.openDirections(cell);
+  const uint64_t horizontalCenters = walls.availableHorizontalCenters();
+  const uint64_t verticalCenters = walls.availableVerticalCenters();
+
+  int candidates[2 * DIRECTION_COUNT];
+  MoveType types[2 * DIRECTION_COUNT];
+  int count = 0;
+  for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+    if ((open & directionBit(direction)) == 0
+      || distances.distance(opponent, geometry.neighbour(cell, direction)) != distance - 1)
+    {
+      continue;
+    }
+    const bool across = direction == UP || direction == DOWN;
+    uint64_t blockers = geometry.edgeBlockers(cell, direction) & (across ? horizontalCenters : verticalCenters);
+    while (blockers != 0) {
+      candidates[count] = Bits::popLowestBit(blockers);
+      types[count] = across ? PLACE_HORIZONAL_WALL : PLACE_VERTICAL_WALL;
+      ++count;
+    }
+  }
+
+  // Try a couple at random, most keep the paths open and that check walks the board.
+  for (int attempt = 0; attempt < 2 && count > 0; ++attempt) {
+    const int pick = _random.below(count);
+    const int center = candidates[pick];
+    const Move wall(player, types[pick], Point(center % WALL_CENTERS_PER_ROW, center / WALL_CENTERS_PER_ROW));
+    if (board.isLegal(wall)) {
+      return wall;
+    }
+    candidates[pick] = candidates[count - 1];
+    types[pick] = types[count - 1];
+    --count;
+  }
+  return boost::none;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "Board.hpp"
+#include "Util/Random.hpp"
+
+namespace Quoridor {
+
+  const int DEFAULT_ROLLOUT_PLIES = 200;
+
+  struct RolloutResult {
+    // Empty when the ply limit ran out first.
+    boost::optional<Player> winner;
+    int plies;
+    // Static evaluation where the rollout stopped, from the point of view of the player to move at
+    // the start. Only set when there is no winner.
+    int evaluation;
+  };
+
+  // Plays a game out quickly. Pawns step along a shortest route to goal nearly every move, a random
+  // step now and then keeping games from repeating. Now and then a player with walls left instead
+  // puts one across the opponent's next shortest step. Pure random play rarely ends, since pawns
+  // wander and random walls mostly do nothing.
+  //
+  // Not thread safe, each thread should own a policy with its own seed.
+  class RolloutPolicy {
+  public:
+    explicit RolloutPolicy(uint64_t seed);
+
+    // Plays from the position until someone wins or the ply limit is reached, then takes every move
+    // back so the board is left as it was. The board must have goal distances enabled.
+    RolloutResult play(Board& board, int maxPlies = DEFAULT_ROLLOUT_PLIES);
+
+    // Chance a player with walls left tries a wall instead of stepping.
+    inline void setWallProbability(float probability) {
+      _wallProbability = probability;
+    }
+    // Chance of a random pawn move instead of a shortest route step.
+    inline void setRandomStepProbability(float probability) {
+      _randomStepProbability = probability;
+    }
+
+    // A legal wall across one of the opponent's shortest routes, or nothing if the tries found none.
+    // The board must have goal distances enabled.
+    boost::optional<Move> chooseWall(const Board& board);
+
+    // Total plies played over the policy's lifetime, for measuring throughput.
+    inline uint64_t pliesPlayed() const {
+      return _pliesPlayed;
+    }
+  private:
+    Move chooseMove(const Board& board);
+
+    Random::Xoshiro256 _random;
+    float _wallProbability;
+    float _randomStepProbability;
+    uint64_t _pliesPlayed;
+    std::vector<MoveUndo> _undos;
+  };
+}
@@ -0,0 +1,364 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "Search.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+// How often, in nodes, the clock and node budget are looked at.
+static const uint64_t LIMIT_CHECK_INTERVAL = 1024;
+static const int ASPIRATION_WINDOW = 50;
+static const int ASPIRATION_MIN_DEPTH = 3;
+// Below this depth moves are cheaper to search twice than to coordinate.
+static const int DEFERRAL_MIN_DEPTH = 3;
+
+SearchEngine::SearchEngine(size_t transpositionTableMegabytes)
+  : _table(new TranspositionTable(transpositionTableMegabytes))
+  , _sharedTable(nullptr)
+  , _nodes(0)
+  , _nodesReported(0)
+  , _sharedState(nullptr)
+  , _helperIndex(0)
+  , _staggerDepths(false)
+  , _pruneWalls(false)
+  , _stopped(false)
+  , _followPrincipalVariation(false)
+{ }
+
+SearchEngine::SearchEngine(SharedTranspositionTable& sharedTable)
+  : _sharedTable(&sharedTable)
+  , _nodes(0)
+  , _nodesReported(0)
+  , _sharedState(nullptr)
+  , _helperIndex(0)
+  , _staggerDepths(false)
+  , _pruneWalls(false)
+  , _stopped(false)
+  , _followPrincipalVariation(false)
+{ }
+
+SearchResult SearchEngine::search(const Board& board, const SearchLimits& limits) {
+  _board = board;
+  _board.enableGoalDistances();
+  _limits = limits;
+  _start = chrono::steady_clock::now();
+  _nodes = 0;
+  _nodesReported = 0;
+  _stopped = false;
+  _previousPrincipalVariation.clear();
+  _ordering.newSearch();
+  if (_table) {
+    _table->newSearch();
+  }
+  const uint64_t raceTablesBefore = _raceSolver.tablesBuilt();
+
+  SearchResult result;
+  if (_board.winner()) {
+    return result;
+  }
+
+  int previousScore = 0;
+  for (int depth = 1; depth <= _limits.maxDepth && !_stopped; ++depth) {
+    if (skipsDepth(depth)) {
+      continue;
+    }
+    // Search a narrow window around the last score first and only widen it when the score falls
+    // outside, which is rare once the iterations settle down.
+    int delta = ASPIRATION_WINDOW;
+    int alpha = -INFINITE_SCORE;
+    int beta = INFINITE_SCORE;
+    if (depth >= ASPIRATION_MIN_DEPTH && !isWinScore(previousScore)) {
+      alpha = max(previousScore - delta, -INFINITE_SCORE);
+      beta = min(previousScore + delta, INFINITE_SCORE);
+    }
+
+    int score;
+    while (true) {
+      _followPrincipalVariation = true;
+      score = searchRoot(depth, alpha, beta);
+      if (_stopped) {
+        break;
+      }
+      if (score <= alpha) {
+        alpha = max(score - delta, -INFINITE_SCORE);
+      }
+      else if (score >= beta) {
+        beta = min(score + delta, INFINITE_SCORE);
+      }
+      else {
+        break;
+      }
+      delta *= 2;
+    }
+    // A partial iteration is thrown away, the previous one stands.
+    if (_stopped || _principalVariation[0].empty()) {
+      break;
+    }
+
+    previousScore = score;
+    _previousPrincipalVariation = _principalVariation[0];
+    result.bestMove = _principalVariation[0][0];
+    result.score = score;
+    result.depth = depth;
+    result.principalVariation.assign(begin(_principalVariation[0]), end(_principalVariation[0]));
+    result.nodes = _nodes;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    if (_onIteration) {
+      _onIteration(result);
+    }
+    // Nothing deeper will change a forced result.
+    if (isWinScore(score) && WIN_SCORE - abs(score) <= depth) {
+      break;
+    }
+    // In a parallel search the main thread speaks for all of them.
+    if (_limits.timeManager && _helperIndex == 0 && _limits.timeManager->checkpoint(*result.bestMove)) {
+      break;
+    }
+  }
+
+  if (_sharedState) {
+    _sharedState->nodes += _nodes - _nodesReported;
+    _nodesReported = _nodes;
+  }
+  result.nodes = _nodes;
+  result.seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+  result.raceTablesBuilt = _raceSolver.tablesBuilt() - raceTablesBefore;
+  return result;
+}
+
+int SearchEngine::searchRoot(int depth, int alpha, int beta) {
+  return searchNode(depth, alpha, beta, 0);
+}
+
+int SearchEngine::searchNode(int depth, int alpha, int beta, int ply) {
+  _principalVariation[ply].clear();
+  if (++_nodes % LIMIT_CHECK_INTERVAL == 0) {
+    checkLimits();
+  }
+  if (_limits.timeManager && _limits.timeManager->poll(_nodes) && !_previousPrincipalVariation.empty()) {
+    _stopped = true;
+  }
+  if (_stopped) {
+    return 0;
+  }
+  // Whoever moved last has just won.
+  if (_board.winner()) {
+    return -(WIN_SCORE - ply);
+  }
+  // Out of walls the rest is a pawn race, solved exactly once the opponent is out too and before
+  // that only when the opponent plainly wins it. A loss whose length is only bounded would make a
+  // wrong mate distance, so that is left to the search, as is the root so there is a move to return.
+  if (ply > 0 && _board.wallCount(_board.currentPlayer()) == 0) {
+    const boost::optional<RaceOutcome> race = _raceSolver.solve(_board);
+    if (race && race->exact) {
+      if (!race->winner) {
+        return 0;
+      }
+      const int score = WIN_SCORE - (ply + race->plies);
+      return *race->winner == _board.currentPlayer() ? score : -score;
+    }
+  }
+  if (depth <= 0 || ply >= MAX_SEARCH_PLY - 1) {
+    return evaluate(_board);
+  }
+
+  // Principal variation nodes are searched with an open window, they never take a cutoff from the
+  // table so the line reported stays complete.
+  const bool isPrincipalVariation = beta - alpha > 1;
+  const uint64_t key = _board.zobristKey();
+  TranspositionHit hit;
+  boost::optional<Move> hashMove;
+  if (probeTable(key, ply, hit)) {
+    hashMove = hit.move;
+    if (!isPrincipalVariation && ply > 0 && hit.depth >= depth) {
+      if ((hit.bound == BOUND_EXACT)
+        || (hit.bound == BOUND_LOWER && hit.score >= beta)
+        || (hit.bound == BOUND_UPPER && hit.score <= alpha)) {
+        return hit.score;
+      }
+    }
+  }
+
+  // Along the previous iteration's principal variation its move is the best guess, ahead of the
+  // table's.
+  boost::optional<Move> firstGuess = hashMove;
+  if (_followPrincipalVariation) {
+    if (ply < _previousPrincipalVariation.size()) {
+      firstGuess = _previousPrincipalVariation[ply];
+    }
+    else {
+      _followPrincipalVariation = false;
+    }
+  }
+  MovePicker picker(_board, _ordering, ply, firstGuess, _pruneWalls && ply > 0);
+  const Player player = _board.currentPlayer();
+  const Point from = _board.playerPosition(player);
+
+  const int originalAlpha = alpha;
+  int bestScore = -INFINITE_SCORE;
+  boost::optional<Move> bestMove;
+  bool firstMove = true;
+  MoveId tried[MAX_MOVES];
+  int triedCount = 0;
+
+  // Once the first move is done, moves another thread is already searching are put off until the
+  // end. By then that thread has usually stored the result, and this one has found other work.
+  ActiveMoveTable* activeMoves = (_sharedState && depth >= DEFERRAL_MIN_DEPTH) ? _sharedState->activeMoves : nullptr;
+  MoveList deferred;
+  int nextDeferred = 0;
+  while (true) {
+    boost::optional<Move> next = picker.next();
+    const bool isDeferred = !next && nextDeferred < deferred.size();
+    if (isDeferred) {
+      next = deferred[nextDeferred++];
+    }
+    if (!next) {
+      break;
+    }
+    const Move& move = *next;
+    const uint64_t moveHash = key ^ (packMove(move) * 0x9E3779B97F4A7C15ULL);
+    if (activeMoves && !isDeferred && !firstMove && activeMoves->contains(moveHash)) {
+      deferred.push_back(move);
+      continue;
+    }
+
+    if (activeMoves) {
+      activeMoves->add(moveHash);
+    }
+    const int score = searchMove(move, depth, alpha, beta, ply, firstMove);
+    if (activeMoves) {
+      activeMoves->remove(moveHash);
+    }
+    firstMove = false;
+    if (_stopped) {
+      return 0;
+    }
+
+    const MoveId id = moveId(move, from);
+    if (score > bestScore) {
+      bestScore = score;
+      bestMove = move;
+      if (score > alpha) {
+        alpha = score;
+        updatePrincipalVariation(ply, move);
+        if (alpha >= beta) {
+          _ordering.addKiller(ply, id);
+          _ordering.recordCutoff(player, id, tried, triedCount, depth);
+          break;
+        }
+      }
+    }
+    tried[triedCount++] = id;
+  }
+  if (firstMove) {
+    return evaluate(_board);
+  }
+
+  const Bound bound = bestScore >= beta ? BOUND_LOWER : (bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+  storeTable(key, ply, depth, bestScore, bound, bestMove);
+  return bestScore;
+}
+
+int SearchEngine::searchMove(const Move& move, int depth, int alpha, int beta, int ply, bool firstMove) {
+  const MoveUndo undo = _board.doMove(move);
+  int score;
+  if (firstMove) {
+    score = -searchNode(depth - 1, -beta, -alpha, ply + 1);
+  }
+  else {
+    // Prove the move is no better than the best so far with a null window, and only search it
+    // properly if that fails.
+    score = -searchNode(depth - 1, -alpha - 1, -alpha, ply + 1);
+    if (score > alpha && score < beta) {
+      score = -searchNode(depth - 1, -beta, -alpha, ply + 1);
+    }
+  }
+  _board.undoMove(undo);
+  _followPrincipalVariation = false;
+  return score;
+}
+
+void SearchEngine::updatePrincipalVariation(int ply, const Move& move) {
+  Line& line = _principalVariation[ply];
+  line.clear();
+  line.push_back(move);
+  for (const Move& next : _principalVariation[ply + 1]) {
+    line.push_back(next);
+  }
+}
+
+void SearchEngine::checkLimits() {
+  uint64_t nodes = _nodes;
+  if (_sharedState) {
+    nodes = (_sharedState->nodes += _nodes - _nodesReported);
+    _nodesReported = _nodes;
+    if (_sharedState->stop.load(memory_order_relaxed)) {
+      _stopped = true;
+    }
+  }
+  if (_limits.maxNodes != 0 && nodes >= _limits.maxNodes) {
+    _stopped = true;
+  }
+  if (_limits.maxTime.count() != 0 && chrono::steady_clock::now() - _start >= _limits.maxTime) {
+    _stopped = true;
+  }
+}
+
+void SearchEngine::joinParallelSearch(SharedSearchState* state, int helperIndex, bool staggerDepths) {
+  _sharedState = state;
+  _helperIndex = helperIndex;
+  _staggerDepths = staggerDepths;
+}
+
+// Helpers are grouped in pairs, fours, sixes and so on. A group of size n alternates between
+// searching and skipping runs of n depths, each helper in the group starting at a different phase.
+static const int SKIP_SIZE[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static const int SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+static const int SKIP_PATTERNS = sizeof(SKIP_SIZE) / sizeof(SKIP_SIZE[0]);
+
+bool SearchEngine::skipsDepth(int depth) const {
+  if (!_staggerDepths || _helperIndex == 0) {
+    return false;
+  }
+  const int pattern = (_helperIndex - 1) % SKIP_PATTERNS;
+  return ((depth + SKIP_PHASE[pattern]) / SKIP_SIZE[pattern]) % 2 != 0;
+}
+
+bool SearchEngine::probeTable(uint64_t key, int ply, TranspositionHit& hit) const {
+  return _sharedTable ? _sharedTable->probe(key, ply, hit) : _table->probe(key, ply, hit);
+}
+
+void SearchEngine::storeTable(uint64_t key, int ply, int depth, int score, Bound bound, const boost::optional<Move>& move) {
+  if (_sharedTable) {
+    _sharedTable->store(key, ply, depth, score, bound, move);
+  }
+  else {
+    _table->store(key, ply, depth, score, bound, move);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Active Move Table
+//////////////////////////////////////////////////////////////////////////
+
+ActiveMoveTable::ActiveMoveTable() {
+  for (atomic<uint64_t>& slot : _slots) {
+    slot.store(0, memory_order_relaxed);
+  }
+}
+
+bool ActiveMoveTable::contains(uint64_t moveHash) const {
+  return _slots[moveHash % SLOT_COUNT].load(memory_order_relaxed) == moveHash;
+}
+
+void ActiveMoveTable::add(uint64_t moveHash) {
+  _slots[moveHash % SLOT_COUNT].store(moveHash, memory_order_relaxed);
+}
+
+void ActiveMoveTable::remove(uint64_t moveHash) {
+  // Leave the slot alone if another move has taken it over since.
+  uint64_t expected = moveHash;
+  _slots[moveHash % SLOT_COUNT].compare_exchange_strong(expected, 0, memory_order_relaxed);
+}
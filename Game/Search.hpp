@@ -0,0 +1,156 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Board.hpp"
+#include "Evaluation.hpp"
+#include "MoveOrdering.hpp"
+#include "PawnRace.hpp"
+#include "SharedTranspositionTable.hpp"
+#include "TimeManager.hpp"
+#include "TranspositionTable.hpp"
+
+namespace Quoridor {
+
+  const int MAX_SEARCH_PLY = 128;
+  static_assert(MAX_SEARCH_PLY <= MAX_ORDERING_PLY, "Move ordering must cover every ply of the search");
+  const size_t DEFAULT_TRANSPOSITION_TABLE_MEGABYTES = 16;
+
+  // Any combination of limits may be set, the search stops at whichever is hit first. A zero node or
+  // time budget means no limit.
+  struct SearchLimits {
+    SearchLimits()
+      : maxDepth(MAX_SEARCH_PLY - 1)
+      , maxNodes(0)
+      , maxTime(0)
+      , timeManager(nullptr)
+    {}
+
+    int maxDepth;
+    uint64_t maxNodes;
+    std::chrono::milliseconds maxTime;
+    // Game clock deadlines for the move, already started. Polled at its own interval, and told the
+    // best move after every iteration. The first iteration always completes so there is a move.
+    TimeManager* timeManager;
+  };
+
+  struct SearchResult {
+    SearchResult()
+      : score(0)
+      , depth(0)
+      , nodes(0)
+      , seconds(0)
+      , raceTablesBuilt(0)
+    {}
+
+    inline double nodesPerSecond() const {
+      return seconds > 0 ? nodes / seconds : 0;
+    }
+
+    boost::optional<Move> bestMove;
+    int score;
+    // Deepest fully completed iteration.
+    int depth;
+    uint64_t nodes;
+    double seconds;
+    // Pawn race tables this search had to build, see PawnRaceSolver.
+    uint64_t raceTablesBuilt;
+    std::vector<Move> principalVariation;
+  };
+
+  // Moves some thread is searching right now, identified by a hash of the position and the move.
+  // Collisions only cost a needless deferral or a duplicated search, never a wrong result.
+  class ActiveMoveTable {
+  public:
+    ActiveMoveTable();
+
+    bool contains(uint64_t moveHash) const;
+    void add(uint64_t moveHash);
+    void remove(uint64_t moveHash);
+  private:
+    static const int SLOT_COUNT = 1 << 15;
+
+    std::atomic<uint64_t> _slots[SLOT_COUNT];
+  };
+
+  // State shared by the engines of a parallel search. Any engine may raise the stop flag, and node
+  // budgets are checked against the combined count. With an active move table the engines defer
+  // moves another engine is busy with, ABDADA style.
+  struct SharedSearchState {
+    SharedSearchState()
+      : stop(false)
+      , nodes(0)
+      , activeMoves(nullptr)
+    {}
+
+    std::atomic<bool> stop;
+    std::atomic<uint64_t> nodes;
+    ActiveMoveTable* activeMoves;
+  };
+
+  // Iterative deepening negamax with principal variation search and aspiration windows.
+  class SearchEngine {
+  public:
+    typedef std::function<void(const SearchResult&)> IterationCallback;
+
+    explicit SearchEngine(size_t transpositionTableMegabytes = DEFAULT_TRANSPOSITION_TABLE_MEGABYTES);
+    // Searches with a table that other engines may be using at the same time. Whoever owns the table
+    // calls newSearch on it, the engine leaves it alone.
+    explicit SearchEngine(SharedTranspositionTable& sharedTable);
+
+    SearchResult search(const Board& board, const SearchLimits& limits);
+
+    // Joins a parallel search. With staggering, helpers (index 1 and up) skip some iteration depths
+    // according to their index so that the threads spread out over different depths rather than all
+    // repeating the same work. Index 0 always searches every depth.
+    void joinParallelSearch(SharedSearchState* state, int helperIndex, bool staggerDepths);
+
+    // Below the root, only search walls that cross the opponent's shortest routes, touch a pawn or
+    // extend an existing wall. Much narrower, but no longer exact. Off by default.
+    inline void setWallPruning(bool pruneWalls) {
+      _pruneWalls = pruneWalls;
+    }
+
+    // Called after every completed iteration with the result so far.
+    inline void setIterationCallback(IterationCallback callback) {
+      _onIteration = callback;
+    }
+  private:
+    int searchRoot(int depth, int alpha, int beta);
+    int searchNode(int depth, int alpha, int beta, int ply);
+    int searchMove(const Move& move, int depth, int alpha, int beta, int ply, bool firstMove);
+    void updatePrincipalVariation(int ply, const Move& move);
+    void checkLimits();
+    bool skipsDepth(int depth) const;
+    bool probeTable(uint64_t key, int ply, TranspositionHit& hit) const;
+    void storeTable(uint64_t key, int ply, int depth, int score, Bound bound, const boost::optional<Move>& move);
+
+    typedef FixedMoveList<MAX_SEARCH_PLY> Line;
+
+    Board _board;
+    MoveOrdering _ordering;
+    PawnRaceSolver _raceSolver;
+    // Exactly one of these is set.
+    std::unique_ptr<TranspositionTable> _table;
+    SharedTranspositionTable* _sharedTable;
+    SearchLimits _limits;
+    std::chrono::steady_clock::time_point _start;
+    uint64_t _nodes;
+    uint64_t _nodesReported;
+    SharedSearchState* _sharedState;
+    int _helperIndex;
+    bool _staggerDepths;
+    bool _pruneWalls;
+    bool _stopped;
+    bool _followPrincipalVariation;
+    Line _previousPrincipalVariation;
+    Line _principalVariation[MAX_SEARCH_PLY];
+    IterationCallback _onIteration;
+  };
+}
@@ -0,0 +1,140 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "SharedTranspositionTable.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+// Layout of an entry's data word.
+static const int DATA_SCORE_SHIFT = 16;
+static const int DATA_DEPTH_SHIFT = 32;
+static const int DATA_BOUND_SHIFT = 40;
+
+static uint64_t packData(uint16_t move, int score, int depth, uint8_t boundAndGeneration) {
+  return static_cast<uint64_t>(move)
+    | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << DATA_SCORE_SHIFT)
+    | (static_cast<uint64_t>(depth) << DATA_DEPTH_SHIFT)
+    | (static_cast<uint64_t>(boundAndGeneration) << DATA_BOUND_SHIFT);
+}
+
+static inline uint16_t dataMove(uint64_t data) {
+  return static_cast<uint16_t>(data);
+}
+static inline int dataScore(uint64_t data) {
+  return static_cast<int16_t>(data >> DATA_SCORE_SHIFT);
+}
+static inline int dataDepth(uint64_t data) {
+  return static_cast<uint8_t>(data >> DATA_DEPTH_SHIFT);
+}
+static inline uint8_t dataBoundAndGeneration(uint64_t data) {
+  return static_cast<uint8_t>(data >> DATA_BOUND_SHIFT);
+}
+
+SharedTranspositionTable::SharedTranspositionTable(size_t megabytes)
+  : _buckets(nullptr)
+  , _bucketCount(0)
+  , _generation(0)
+{
+  resize(megabytes);
+}
+
+void SharedTranspositionTable::resize(size_t megabytes) {
+  _bucketCount = max<size_t>(1, (megabytes << 20) / sizeof(SharedTranspositionBucket));
+  const size_t alignment = alignof(SharedTranspositionBucket);
+  _memory.reset(new char[_bucketCount * sizeof(SharedTranspositionBucket) + alignment]);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(_memory.get());
+  _buckets = reinterpret_cast<SharedTranspositionBucket*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+  // The atomics are trivially destructible, so the buffer can simply be released later.
+  for (size_t i = 0; i < _bucketCount; ++i) {
+    new (&_buckets[i]) SharedTranspositionBucket();
+  }
+  clear();
+}
+
+void SharedTranspositionTable::clear() {
+  for (size_t i = 0; i < _bucketCount; ++i) {
+    for (SharedTranspositionEntry& entry : _buckets[i].entries) {
+      entry.check.store(0, memory_order_relaxed);
+      entry.data.store(0, memory_order_relaxed);
+    }
+  }
+  _generation = 0;
+}
+
+void SharedTranspositionTable::newSearch() {
+  _generation += GENERATION_STEP;
+}
+
+SharedTranspositionBucket& SharedTranspositionTable::bucketFor(uint64_t key) const {
+  const uint64_t index = ((key >> 32) * static_cast<uint64_t>(_bucketCount)) >> 32;
+  return _buckets[index];
+}
+
+bool SharedTranspositionTable::probe(uint64_t key, int ply, TranspositionHit& hit) const {
+  const SharedTranspositionBucket& bucket = bucketFor(key);
+  for (const SharedTranspositionEntry& entry : bucket.entries) {
+    const uint64_t data = entry.data.load(memory_order_relaxed);
+    const uint64_t check = entry.check.load(memory_order_relaxed);
+    const Bound bound = static_cast<Bound>(dataBoundAndGeneration(data) & BOUND_MASK);
+    if ((check ^ data) == key && bound != BOUND_NONE) {
+      hit.move = unpackMove(dataMove(data));
+      hit.score = scoreFromTable(dataScore(data), ply);
+      hit.depth = dataDepth(data);
+      hit.bound = bound;
+      return true;
+    }
+  }
+  return false;
+}
+
+void SharedTranspositionTable::store(uint64_t key, int ply, int depth, int score, Bound bound, const boost::optional<Move>& move) {
+  ARC_ASSERT(depth >= 0 && depth <= UINT8_MAX);
+  SharedTranspositionBucket& bucket = bucketFor(key);
+
+  // Decisions are made on a snapshot, if another thread writes the bucket meanwhile one of the two
+  // results is lost, which costs nothing but a little search.
+  SharedTranspositionEntry* victim = nullptr;
+  uint16_t previousMove = 0;
+  int victimWorth = INT_MAX;
+  for (SharedTranspositionEntry& entry : bucket.entries) {
+    const uint64_t data = entry.data.load(memory_order_relaxed);
+    const uint64_t check = entry.check.load(memory_order_relaxed);
+    const bool used = (dataBoundAndGeneration(data) & BOUND_MASK) != BOUND_NONE;
+    const uint8_t generation = dataBoundAndGeneration(data) & ~BOUND_MASK;
+    if (used && (check ^ data) == key) {
+      if (bound != BOUND_EXACT && generation == _generation && depth < dataDepth(data)) {
+        return;
+      }
+      victim = &entry;
+      previousMove = dataMove(data);
+      break;
+    }
+    const int worth = used ? replacementWorth(dataDepth(data), generation, _generation) : INT_MIN;
+    if (worth < victimWorth) {
+      victim = &entry;
+      victimWorth = worth;
+    }
+  }
+
+  const uint16_t packedMove = move ? packMove(*move) : previousMove;
+  const uint64_t data = packData(packedMove, scoreToTable(score, ply), depth, static_cast<uint8_t>(_generation | bound));
+  victim->data.store(data, memory_order_relaxed);
+  victim->check.store(key ^ data, memory_order_relaxed);
+}
+
+int SharedTranspositionTable::hashfull() const {
+  const size_t sampleBuckets = min<size_t>(_bucketCount, 1000 / SHARED_TRANSPOSITION_BUCKET_SIZE);
+  int used = 0;
+  for (size_t i = 0; i < sampleBuckets; ++i) {
+    for (const SharedTranspositionEntry& entry : _buckets[i].entries) {
+      const uint8_t boundAndGeneration = dataBoundAndGeneration(entry.data.load(memory_order_relaxed));
+      if ((boundAndGeneration & BOUND_MASK) != BOUND_NONE && (boundAndGeneration & ~BOUND_MASK) == _generation) {
+        ++used;
+      }
+    }
+  }
+  return static_cast<int>(used * 1000 / (sampleBuckets * SHARED_TRANSPOSITION_BUCKET_SIZE));
+}
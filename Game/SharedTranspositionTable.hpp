@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "TranspositionTable.hpp"
+
+namespace Quoridor {
+
+  // An entry is two 64 bit words, the packed data and the full key XORed with that data. Writers
+  // store both words without any locking, so a reader can see one word from one write and the other
+  // from another. Such a torn entry no longer decodes to the key being probed and reads as a miss.
+  struct SharedTranspositionEntry {
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+  };
+
+  const int SHARED_TRANSPOSITION_BUCKET_SIZE = 4;
+
+  struct alignas(64) SharedTranspositionBucket {
+    SharedTranspositionEntry entries[SHARED_TRANSPOSITION_BUCKET_SIZE];
+  };
+  static_assert(sizeof(SharedTranspositionBucket) == 64, "Transposition buckets must fill one cache line");
+
+  // Transposition table that any number of search threads may probe and store into at once. Same
+  // replacement scheme as TranspositionTable, with a full key check instead of a 16 bit fragment.
+  // Resizing, clearing and newSearch must not overlap with searches.
+  class SharedTranspositionTable {
+  public:
+    explicit SharedTranspositionTable(size_t megabytes);
+
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch();
+
+    bool probe(uint64_t key, int ply, TranspositionHit& hit) const;
+    void store(uint64_t key, int ply, int depth, int score, Bound bound, const boost::optional<Move>& move);
+
+    inline size_t bucketCount() const {
+      return _bucketCount;
+    }
+    inline size_t sizeInBytes() const {
+      return _bucketCount * sizeof(SharedTranspositionBucket);
+    }
+    int hashfull() const;
+  private:
+    SharedTranspositionBucket& bucketFor(uint64_t key) const;
+
+    std::unique_ptr<char[]> _memory;
+    SharedTranspositionBucket* _buckets;
+    size_t _bucketCount;
+    uint8_t _generation;
+  };
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+
+#include "Symmetry.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+Point Quoridor::transformWallCenter(Point center, Symmetry symmetry) {
+  const int8_t last = WALL_CENTERS_PER_ROW - 1;
+  const bool mirrorX = symmetry == MIRROR || symmetry == ROTATE_SWAP;
+  const bool mirrorY = symmetry == ROTATE_SWAP || symmetry == FLIP_SWAP;
+  return{ mirrorX ? static_cast<int8_t>(last - center.x()) : center.x(),
+          mirrorY ? static_cast<int8_t>(last - center.y()) : center.y() };
+}
+
+Direction Quoridor::transformDirection(Direction direction, Symmetry symmetry) {
+  const bool mirrorX = symmetry == MIRROR || symmetry == ROTATE_SWAP;
+  const bool mirrorY = symmetry == ROTATE_SWAP || symmetry == FLIP_SWAP;
+  switch (direction) {
+  case UP:
+    return mirrorY ? DOWN : UP;
+  case DOWN:
+    return mirrorY ? UP : DOWN;
+  case LEFT:
+    return mirrorX ? RIGHT : LEFT;
+  case RIGHT:
+    return mirrorX ? LEFT : RIGHT;
+  default:
+    ARC_FAIL("Invalid direction!");
+    return direction;
+  }
+}
+
+MoveInfo Quoridor::transformMoveInfo(MoveType type, const MoveInfo& info, Symmetry symmetry) {
+  switch (type) {
+  case MOVE_PIECE:
+    return MoveInfo(transformDirection(info.pieceMoveDirection, symmetry));
+  case JUMP_PIECE:
+    return MoveInfo(BoardGeometry::instance().point(transformCell(cellIndex(info.jumpDestination), symmetry)));
+  default:
+    return MoveInfo(transformWallCenter(info.wallCenter, symmetry));
+  }
+}
+
+Move Quoridor::transformMove(const Move& move, Symmetry symmetry) {
+  Move transformed = move;
+  transformed.player = swapsPlayers(symmetry) ? opponentOf(move.player) : move.player;
+  transformed.info = transformMoveInfo(move.type, move.info, symmetry);
+  return transformed;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Board.hpp"
+#include "BoardGeometry.hpp"
+
+// Helpers for applying a Symmetry to the pieces of a position. Every symmetry is its own inverse so
+// the same call maps both ways.
+namespace Quoridor {
+
+  inline int transformCell(int cell, Symmetry symmetry) {
+    const int x = cell % BOARD_SIZE;
+    const int y = cell / BOARD_SIZE;
+    const int mirroredX = symmetry == MIRROR || symmetry == ROTATE_SWAP ? BOARD_SIZE - 1 - x : x;
+    const int mirroredY = symmetry == ROTATE_SWAP || symmetry == FLIP_SWAP ? BOARD_SIZE - 1 - y : y;
+    return cellIndex(mirroredX, mirroredY);
+  }
+
+  // Wall centers are an 8x8 grid with one row per byte, so mirroring reverses the bits of each byte,
+  // flipping reverses the byte order and rotating does both.
+  inline uint64_t transformCenters(uint64_t centers, Symmetry symmetry) {
+    static_assert(WALL_CENTERS_PER_ROW == 8, "Center transforms assume one row of centers per byte");
+    switch (symmetry) {
+    case MIRROR:
+      return Bits::reverseBitsInBytes(centers);
+    case ROTATE_SWAP:
+      return Bits::reverseBitsInBytes(Bits::byteSwap(centers));
+    case FLIP_SWAP:
+      return Bits::byteSwap(centers);
+    default:
+      return centers;
+    }
+  }
+
+  Point transformWallCenter(Point center, Symmetry symmetry);
+  Direction transformDirection(Direction direction, Symmetry symmetry);
+  MoveInfo transformMoveInfo(MoveType type, const MoveInfo& info, Symmetry symmetry);
+  // The equivalent move in the transformed position, including handing it to the other player for
+  // symmetries that swap them.
+  Move transformMove(const Move& move, Symmetry symmetry);
+}
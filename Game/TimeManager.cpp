@@ -0,0 +1,75 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "Util/Arc_Assert.hpp"
+#include "TimeManager.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+// Moves the time is assumed to have to cover when the control does not say. Games rarely run past
+// forty moves a side, and moves near the end need little thought.
+static const int DEFAULT_MOVES_TO_GO = 25;
+// Share of the increment spent on each move on top of the even share of the clock.
+static const double INCREMENT_SHARE = 0.75;
+// The hard deadline is this many times the soft one, but never more than this share of the clock.
+static const double HARD_FACTOR = 4;
+static const double HARD_SHARE = 0.5;
+// Checkpoints agreeing on the best move before the soft deadline is brought in.
+static const int STABLE_CHECKPOINTS = 3;
+static const double STABLE_SCALE = 0.5;
+static const double CHANGED_SCALE = 1.5;
+
+TimeManager::TimeManager(uint64_t pollInterval)
+  : _pollMask(pollInterval - 1)
+  , _start(EngineClock::now())
+  , _soft(EngineClock::duration::zero())
+  , _hard(EngineClock::duration::zero())
+  , _expired(false)
+  , _stableCheckpoints(0)
+{
+  ARC_ASSERT(pollInterval > 0 && (pollInterval & (pollInterval - 1)) == 0);
+}
+
+void TimeManager::startMove(const TimeControl& control) {
+  const auto available = max(control.remaining - control.moveOverhead, chrono::milliseconds(0));
+  const int movesToGo = control.movesToGo > 0 ? control.movesToGo : DEFAULT_MOVES_TO_GO;
+  const auto share = chrono::duration<double, milli>(available) / movesToGo + INCREMENT_SHARE * control.increment;
+  const auto hard = min(HARD_FACTOR * share, HARD_SHARE * available + INCREMENT_SHARE * control.increment);
+
+  _start = EngineClock::now();
+  _hard = chrono::duration_cast<EngineClock::duration>(min(hard, chrono::duration<double, milli>(available)));
+  _soft = min(chrono::duration_cast<EngineClock::duration>(share), _hard);
+  _expired = false;
+  _bestMove = boost::none;
+  _stableCheckpoints = 0;
+}
+
+bool TimeManager::expired() {
+  if (!_expired.load(memory_order_relaxed) && elapsed() >= _hard) {
+    _expired = true;
+  }
+  return _expired.load(memory_order_relaxed);
+}
+
+bool TimeManager::checkpoint(const Move& bestMove) {
+  double scale = 1;
+  if (_bestMove && *_bestMove == bestMove) {
+    ++_stableCheckpoints;
+    if (_stableCheckpoints >= STABLE_CHECKPOINTS) {
+      scale = STABLE_SCALE;
+    }
+  }
+  else {
+    if (_bestMove) {
+      scale = CHANGED_SCALE;
+    }
+    _bestMove = bestMove;
+    _stableCheckpoints = 0;
+  }
+  if (elapsed() >= chrono::duration_cast<EngineClock::duration>(scale * _soft)) {
+    _expired = true;
+  }
+  return expired();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Board.hpp"
+
+namespace Quoridor {
+
+  // Monotonic clock for everything the engines time, unaffected by changes to the wall clock.
+  typedef std::chrono::steady_clock EngineClock;
+
+  const uint64_t DEFAULT_TIME_POLL_INTERVAL = 1024;
+
+  // The player's clock when it is their turn to move.
+  struct TimeControl {
+    TimeControl()
+      : remaining(0)
+      , increment(0)
+      , movesToGo(0)
+      , moveOverhead(50)
+    {}
+
+    std::chrono::milliseconds remaining;
+    // Added to the clock after every move.
+    std::chrono::milliseconds increment;
+    // Moves to make before the clock is next topped up, zero when the time has to last the game.
+    int movesToGo;
+    // Kept in hand on every move for getting the move to the opponent, so a busy machine does not
+    // lose on time.
+    std::chrono::milliseconds moveOverhead;
+  };
+
+  // Decides how long to spend on a move. Each move gets a soft deadline, past which no new iteration
+  // or batch of simulations starts, and a hard deadline at which the search stops wherever it is.
+  // The soft deadline moves in when the best move has held for a while and out when it just changed.
+  //
+  // Any number of search threads may poll the deadlines. Only one should report checkpoints.
+  class TimeManager {
+  public:
+    // Polls look at the clock once per this many calls. Must be a power of two.
+    explicit TimeManager(uint64_t pollInterval = DEFAULT_TIME_POLL_INTERVAL);
+
+    // Starts the clock for a move and works out its deadlines.
+    void startMove(const TimeControl& control);
+
+    // Whether the search must stop, reading the clock only when the count, typically the caller's
+    // node or simulation count, is a multiple of the poll interval.
+    inline bool poll(uint64_t count) {
+      return (count & _pollMask) == 0 ? expired() : _expired.load(std::memory_order_relaxed);
+    }
+    // Whether the hard deadline has passed or a checkpoint has called time. Reads the clock.
+    bool expired();
+
+    // Reports the best move after a completed iteration or batch of simulations, and returns whether
+    // the search should stop rather than start another.
+    bool checkpoint(const Move& bestMove);
+
+    inline EngineClock::duration elapsed() const {
+      return EngineClock::now() - _start;
+    }
+    inline EngineClock::duration softLimit() const {
+      return _soft;
+    }
+    inline EngineClock::duration hardLimit() const {
+      return _hard;
+    }
+  private:
+    uint64_t _pollMask;
+    EngineClock::time_point _start;
+    EngineClock::duration _soft;
+    EngineClock::duration _hard;
+    std::atomic<bool> _expired;
+    boost::optional<Move> _bestMove;
+    int _stableCheckpoints;
+  };
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "TranspositionTable.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+static const uint16_t MOVE_PRESENT = 0x8000;
+static const int MOVE_PLAYER_SHIFT = 10;
+static const int MOVE_TYPE_SHIFT = 8;
+
+//////////////////////////////////////////////////////////////////////////
+// Move packing
+//////////////////////////////////////////////////////////////////////////
+
+uint16_t Quoridor::packMove(const Move& move) {
+  uint16_t info;
+  if (move.type == MOVE_PIECE) {
+    info = static_cast<uint16_t>(move.info.pieceMoveDirection);
+  }
+  else {
+    info = static_cast<uint16_t>(move.info.wallCenter.x() | (move.info.wallCenter.y() << 4));
+  }
+  return MOVE_PRESENT | (move.player << MOVE_PLAYER_SHIFT) | (move.type << MOVE_TYPE_SHIFT) | info;
+}
+
+boost::optional<Move> Quoridor::unpackMove(uint16_t packed) {
+  if ((packed & MOVE_PRESENT) == 0) {
+    return boost::none;
+  }
+  const Player player = static_cast<Player>((packed >> MOVE_PLAYER_SHIFT) & 1);
+  const MoveType type = static_cast<MoveType>((packed >> MOVE_TYPE_SHIFT) & 3);
+  const int info = packed & 0xFF;
+  if (type == MOVE_PIECE) {
+    return Move(player, static_cast<Direction>(info));
+  }
+  return Move(player, type, Point(info & 0x0F, info >> 4));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Transposition Table
+//////////////////////////////////////////////////////////////////////////
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+  : _buckets(nullptr)
+  , _bucketCount(0)
+  , _generation(0)
+{
+  resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+  _bucketCount = max<size_t>(1, (megabytes << 20) / sizeof(TranspositionBucket));
+  // The default allocator makes no promise about alignment past max_align_t.
+  const size_t alignment = alignof(TranspositionBucket);
+  _memory.reset(new char[_bucketCount * sizeof(TranspositionBucket) + alignment]);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(_memory.get());
+  _buckets = reinterpret_cast<TranspositionBucket*>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+  clear();
+}
+
+void TranspositionTable::clear() {
+  memset(_buckets, 0, _bucketCount * sizeof(TranspositionBucket));
+  _generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+  _generation += GENERATION_STEP;
+}
+
+TranspositionBucket& TranspositionTable::bucketFor(uint64_t key) const {
+  // Scales the upper half of the key onto the bucket count, no power of two size needed.
+  const uint64_t index = ((key >> 32) * static_cast<uint64_t>(_bucketCount)) >> 32;
+  return _buckets[index];
+}
+
+bool TranspositionTable::probe(uint64_t key, int ply, TranspositionHit& hit) const {
+  const uint16_t fragment = static_cast<uint16_t>(key);
+  const TranspositionBucket& bucket = bucketFor(key);
+  for (const TranspositionEntry& entry : bucket.entries) {
+    const Bound bound = static_cast<Bound>(entry.boundAndGeneration & BOUND_MASK);
+    if (entry.key == fragment && bound != BOUND_NONE) {
+      hit.move = unpackMove(entry.move);
+      hit.score = scoreFromTable(entry.score, ply);
+      hit.depth = entry.depth;
+      hit.bound = bound;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TranspositionTable::store(uint64_t key, int ply, int depth, int score, Bound bound, const boost::optional<Move>& move) {
+  ARC_ASSERT(depth >= 0 && depth <= UINT8_MAX);
+  const uint16_t fragment = static_cast<uint16_t>(key);
+  TranspositionBucket& bucket = bucketFor(key);
+
+  TranspositionEntry* victim = nullptr;
+  bool samePosition = false;
+  int victimWorth = INT_MAX;
+  for (TranspositionEntry& entry : bucket.entries) {
+    const bool used = (entry.boundAndGeneration & BOUND_MASK) != BOUND_NONE;
+    const uint8_t generation = entry.boundAndGeneration & ~BOUND_MASK;
+    if (used && entry.key == fragment) {
+      // Keep a deeper result for the same position unless the new one is exact or the old one is
+      // left over from an earlier search.
+      if (bound != BOUND_EXACT && generation == _generation && depth < entry.depth) {
+        return;
+      }
+      victim = &entry;
+      samePosition = true;
+      break;
+    }
+    int worth = INT_MIN;
+    if (used) {
+      worth = replacementWorth(entry.depth, generation, _generation);
+    }
+    if (worth < victimWorth) {
+      victim = &entry;
+      victimWorth = worth;
+    }
+  }
+
+  // Better the old best move for this position than none at all.
+  if (move || !samePosition) {
+    victim->move = move ? packMove(*move) : 0;
+  }
+  victim->key = fragment;
+  victim->score = static_cast<int16_t>(scoreToTable(score, ply));
+  victim->depth = static_cast<uint8_t>(depth);
+  victim->boundAndGeneration = static_cast<uint8_t>(_generation | bound);
+}
+
+int TranspositionTable::hashfull() const {
+  const size_t sampleBuckets = min<size_t>(_bucketCount, 1000 / TRANSPOSITION_BUCKET_SIZE);
+  int used = 0;
+  for (size_t i = 0; i < sampleBuckets; ++i) {
+    for (const TranspositionEntry& entry : _buckets[i].entries) {
+      if ((entry.boundAndGeneration & BOUND_MASK) != BOUND_NONE && (entry.boundAndGeneration & ~BOUND_MASK) == _generation) {
+        ++used;
+      }
+    }
+  }
+  return static_cast<int>(used * 1000 / (sampleBuckets * TRANSPOSITION_BUCKET_SIZE));
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Board.hpp"
+#include "Evaluation.hpp"
+
+namespace Quoridor {
+
+  enum Bound : uint8_t {
+    BOUND_NONE = 0,
+    // Score is at most the stored value, every move failed low.
+    BOUND_UPPER = 1,
+    // Score is at least the stored value, a move failed high.
+    BOUND_LOWER = 2,
+    BOUND_EXACT = BOUND_UPPER | BOUND_LOWER
+  };
+
+  const uint8_t BOUND_MASK = 0x03;
+  // Generations count up in the bits above the bound.
+  const uint8_t GENERATION_STEP = 0x04;
+  const int GENERATION_CYCLE = 0x100;
+  // Each search of age costs an entry as much as this many plies of depth when choosing a victim.
+  const int AGE_WEIGHT = 8;
+
+  // How much an occupied entry is worth keeping, the least valuable in a bucket gets replaced.
+  inline int replacementWorth(int depth, uint8_t entryGeneration, uint8_t currentGeneration) {
+    const int age = ((GENERATION_CYCLE + currentGeneration - entryGeneration) % GENERATION_CYCLE) / GENERATION_STEP;
+    return depth - AGE_WEIGHT * age;
+  }
+
+  // Win scores count plies from the root, but an entry can be reached at any ply, so they are stored
+  // counting from the node itself instead.
+  inline int scoreToTable(int score, int ply) {
+    if (score > WIN_THRESHOLD) {
+      return score + ply;
+    }
+    if (score < -WIN_THRESHOLD) {
+      return score - ply;
+    }
+    return score;
+  }
+
+  inline int scoreFromTable(int score, int ply) {
+    if (score > WIN_THRESHOLD) {
+      return score - ply;
+    }
+    if (score < -WIN_THRESHOLD) {
+      return score + ply;
+    }
+    return score;
+  }
+
+  // What a probe found. Win scores are already relative to the probing node.
+  struct TranspositionHit {
+    boost::optional<Move> move;
+    int score;
+    int depth;
+    Bound bound;
+  };
+
+  // 8 byte table entry. Only 16 bits of the key are kept, the bucket index supplies the rest.
+  struct TranspositionEntry {
+    uint16_t key;
+    uint16_t move;
+    int16_t score;
+    uint8_t depth;
+    // Bound in the low two bits, search generation in the upper six.
+    uint8_t boundAndGeneration;
+  };
+  static_assert(sizeof(TranspositionEntry) == 8, "Transposition entries must stay 8 bytes");
+
+  const int TRANSPOSITION_BUCKET_SIZE = 8;
+
+  // One cache line of entries, a probe never touches more than one line.
+  struct alignas(64) TranspositionBucket {
+    TranspositionEntry entries[TRANSPOSITION_BUCKET_SIZE];
+  };
+  static_assert(sizeof(TranspositionBucket) == 64, "Transposition buckets must fill one cache line");
+
+  // Fixed size hash table of search results keyed by Zobrist key. Replacement prefers deep entries
+  // from the current search over shallow or stale ones, so the table never needs clearing between
+  // moves of a game.
+  class TranspositionTable {
+  public:
+    explicit TranspositionTable(size_t megabytes);
+
+    // Discards every entry and reallocates to the given size.
+    void resize(size_t megabytes);
+    void clear();
+    // Marks the start of a new search, entries from older searches become the first to be replaced.
+    void newSearch();
+
+    bool probe(uint64_t key, int ply, TranspositionHit& hit) const;
+    void store(uint64_t key, int ply, int depth, int score, Bound bound, const boost::optional<Move>& move);
+
+    inline size_t bucketCount() const {
+      return _bucketCount;
+    }
+    inline size_t sizeInBytes() const {
+      return _bucketCount * sizeof(TranspositionBucket);
+    }
+    // Permille of a sample of the table filled by the current search.
+    int hashfull() const;
+  private:
+    TranspositionBucket& bucketFor(uint64_t key) const;
+
+    std::unique_ptr<char[]> _memory;
+    TranspositionBucket* _buckets;
+    size_t _bucketCount;
+    uint8_t _generation;
+  };
+
+  // 16 bit move encoding used for storage, zero means no move.
+  uint16_t packMove(const Move& move);
+  boost::optional<Move> unpackMove(uint16_t packed);
+}
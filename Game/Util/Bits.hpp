@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define ARC_HAS_BMI2 1
+#endif
+
+// Small set of portable bit twiddling helpers used by the bitboards.
+namespace Quoridor {
+  namespace Bits {
+
+    inline int popCount(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+      return static_cast<int>(__popcnt64(value));
+#elif defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(value);
+#else
+      value = value - ((value >> 1) & 0x5555555555555555ULL);
+      value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+      value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+      return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    // Index of the lowest set bit. Value must not be zero.
+    inline int lowestBitIndex(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+      unsigned long index;
+      _BitScanForward64(&index, value);
+      return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(value);
+#else
+      int index = 0;
+      while ((value & 1) == 0) {
+        value >>= 1;
+        ++index;
+      }
+      return index;
+#endif
+    }
+
+    // Clears the lowest set bit and returns its index. Value must not be zero.
+    inline int popLowestBit(uint64_t& value) {
+      const int index = lowestBitIndex(value);
+      value &= value - 1;
+      return index;
+    }
+
+    inline uint64_t byteSwap(uint64_t value) {
+#if defined(_MSC_VER)
+      return _byteswap_uint64(value);
+#elif defined(__GNUC__) || defined(__clang__)
+      return __builtin_bswap64(value);
+#else
+      value = ((value & 0x00FF00FF00FF00FFULL) << 8) | ((value >> 8) & 0x00FF00FF00FF00FFULL);
+      value = ((value & 0x0000FFFF0000FFFFULL) << 16) | ((value >> 16) & 0x0000FFFF0000FFFFULL);
+      return (value << 32) | (value >> 32);
+#endif
+    }
+
+    // Reverses the order of the bits within each byte, leaving the bytes where they are.
+    inline uint64_t reverseBitsInBytes(uint64_t value) {
+      value = ((value >> 1) & 0x5555555555555555ULL) | ((value & 0x5555555555555555ULL) << 1);
+      value = ((value >> 2) & 0x3333333333333333ULL) | ((value & 0x3333333333333333ULL) << 2);
+      return ((value >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((value & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    }
+
+    // Gathers the bits of value selected by mask into the low bits of the result (pext).
+    inline uint64_t extract(uint64_t value, uint64_t mask) {
+#if defined(ARC_HAS_BMI2)
+      return _pext_u64(value, mask);
+#else
+      uint64_t result = 0;
+      for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+        const uint64_t lowest = mask & (0 - mask);
+        if (value & lowest) {
+          result |= bit;
+        }
+        mask ^= lowest;
+      }
+      return result;
+#endif
+    }
+
+    // Scatters the low bits of value into the positions selected by mask (pdep).
+    inline uint64_t deposit(uint64_t value, uint64_t mask) {
+#if defined(ARC_HAS_BMI2)
+      return _pdep_u64(value, mask);
+#else
+      uint64_t result = 0;
+      for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+        const uint64_t lowest = mask & (0 - mask);
+        if (value & bit) {
+          result |= lowest;
+        }
+        mask ^= lowest;
+      }
+      return result;
+#endif
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Quoridor {
+  namespace Random {
+
+    // splitmix64. Fast and well mixed even from small or similar seeds.
+    inline uint64_t splitMix64(uint64_t& state) {
+      uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1) from the top 24 bits.
+    inline float toUnitFloat(uint64_t value) {
+      return static_cast<float>(value >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // xoshiro256**, a small and very fast generator for playouts and other hot loops. Each thread
+    // should own one. The state is filled from the seed with splitmix64, so any seed, zero included,
+    // gives a good stream.
+    class Xoshiro256 {
+    public:
+      explicit Xoshiro256(uint64_t seed) {
+        for (uint64_t& word : _state) {
+          word = splitMix64(seed);
+        }
+      }
+
+      inline uint64_t next() {
+        const uint64_t result = rotateLeft(_state[1] * 5, 7) * 9;
+        const uint64_t t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotateLeft(_state[3], 45);
+        return result;
+      }
+      // Uniform in [0, bound) by multiply and shift. Any bias is below bound / 2^32.
+      inline uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+      }
+      inline float unitFloat() {
+        return toUnitFloat(next());
+      }
+    private:
+      static inline uint64_t rotateLeft(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+      }
+
+      uint64_t _state[4];
+    };
+  }
+}
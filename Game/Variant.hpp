@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Quoridor {
+
+  // Board dimensions and wall supply of a game variant, fixed at compile time so everything sized by
+  // them can be laid out and unrolled by the compiler.
+  template <int SIZE, int WALLS>
+  struct Variant {
+    static_assert(SIZE >= 3 && SIZE <= 9 && SIZE % 2 == 1, "Boards are odd sized so the pawns start mid row, "
+      "and at most 9 wide so the wall centers fit a 64 bit mask");
+    static_assert(WALLS >= 0 && WALLS <= 15, "Wall counts are kept in four bits");
+
+    static const int BOARD_SIZE = SIZE;
+    static const int WALL_CENTERS_PER_ROW = SIZE - 1;
+    static const int WALL_CENTER_COUNT = WALL_CENTERS_PER_ROW * WALL_CENTERS_PER_ROW;
+    // Squares are numbered x + y * BOARD_SIZE.
+    static const int CELL_COUNT = SIZE * SIZE;
+    static const int STARTING_WALL_COUNTS = WALLS;
+  };
+
+  // The standard game, which Board and everything built on it play.
+  typedef Variant<9, 10> StandardVariant;
+}
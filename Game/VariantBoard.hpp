@@ -0,0 +1,187 @@
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <cstdint>
+
+#include "Board.hpp"
+#include "Variant.hpp"
+#include "VariantGeometry.hpp"
+
+namespace Quoridor {
+
+  // Complete game state for a variant, header only so each size is compiled with its dimensions as
+  // constants. Moves come from VariantRules and VariantMovement, the same code Board plays the 9x9
+  // game with, and in the same order. Board adds incremental distances, hashing and packing on top;
+  // this is the small and simple counterpart for experiments and exhaustive solving on small boards.
+  template <int SIZE, int WALLS>
+  class VariantBoard {
+  public:
+    typedef Variant<SIZE, WALLS> Dimensions;
+    typedef VariantGeometry<SIZE> Geometry;
+    typedef VariantRules<SIZE> Rules;
+    static const int CELL_COUNT = Dimensions::CELL_COUNT;
+    static const int WALL_CENTERS_PER_ROW = Dimensions::WALL_CENTERS_PER_ROW;
+    static const int MAX_MOVES = MAX_PIECE_MOVES + 2 * Dimensions::WALL_CENTER_COUNT;
+    typedef FixedMoveList<MAX_MOVES> MoveList;
+
+    struct Undo {
+      Move move;
+      int8_t previousCell;
+    };
+
+    VariantBoard()
+      : _horizontal(0)
+      , _vertical(0)
+      , _currentPlayer(PLAYER_ONE)
+    {
+      _cells[PLAYER_ONE] = static_cast<int8_t>(SIZE / 2);
+      _cells[PLAYER_TWO] = static_cast<int8_t>(SIZE / 2 + (SIZE - 1) * SIZE);
+      _walls[PLAYER_ONE] = WALLS;
+      _walls[PLAYER_TWO] = WALLS;
+    }
+    VariantBoard(int playerOneCell, int playerTwoCell, int playerOneWalls, int playerTwoWalls,
+      uint64_t horizontal, uint64_t vertical, Player currentPlayer)
+      : _horizontal(horizontal)
+      , _vertical(vertical)
+      , _currentPlayer(currentPlayer)
+    {
+      _cells[PLAYER_ONE] = static_cast<int8_t>(playerOneCell);
+      _cells[PLAYER_TWO] = static_cast<int8_t>(playerTwoCell);
+      _walls[PLAYER_ONE] = static_cast<int8_t>(playerOneWalls);
+      _walls[PLAYER_TWO] = static_cast<int8_t>(playerTwoWalls);
+    }
+
+    inline int playerCell(Player player) const {
+      return _cells[player];
+    }
+    inline int wallCount(Player player) const {
+      return _walls[player];
+    }
+    inline Player currentPlayer() const {
+      return _currentPlayer;
+    }
+    inline uint64_t horizontalWalls() const {
+      return _horizontal;
+    }
+    inline uint64_t verticalWalls() const {
+      return _vertical;
+    }
+
+    inline boost::optional<Player> winner() const {
+      if (_cells[PLAYER_ONE] / SIZE == SIZE - 1) {
+        return PLAYER_ONE;
+      }
+      if (_cells[PLAYER_TWO] / SIZE == 0) {
+        return PLAYER_TWO;
+      }
+      return boost::none;
+    }
+
+    inline uint8_t openDirections(int cell) const {
+      return openDirections(cell, _horizontal, _vertical);
+    }
+    static inline uint8_t openDirections(int cell, uint64_t horizontal, uint64_t vertical) {
+      return Rules::openDirections(cell, horizontal, vertical);
+    }
+
+    void availableMoves(MoveList& moves) const {
+      moves.clear();
+      availablePieceMoves(moves);
+      availableWallPlacements(moves);
+    }
+
+    // Steps and jumps for the player to move.
+    void availablePieceMoves(MoveList& moves) const {
+      Rules::availablePieceMoves(_currentPlayer, _cells[_currentPlayer], _cells[opponentOf(_currentPlayer)],
+        _horizontal, _vertical, moves);
+    }
+
+    // Wall placements that collide with no wall and leave both pawns a way to goal, vertical walls
+    // first as Board lists them.
+    void availableWallPlacements(MoveList& moves) const {
+      const Player player = _currentPlayer;
+      if (_walls[player] == 0) {
+        return;
+      }
+      const VariantMovement<SIZE> current(_horizontal, _vertical);
+      uint64_t vertical = Rules::availableVerticalCenters(_horizontal, _vertical);
+      uint64_t horizontal = Rules::availableHorizontalCenters(_horizontal, _vertical);
+      while (vertical != 0) {
+        const int center = Bits::popLowestBit(vertical);
+        if (wallKeepsPathsOpen(current, center, PLACE_VERTICAL_WALL)) {
+          moves.push_back({ player, PLACE_VERTICAL_WALL, centerPoint(center) });
+        }
+      }
+      while (horizontal != 0) {
+        const int center = Bits::popLowestBit(horizontal);
+        if (wallKeepsPathsOpen(current, center, PLACE_HORIZONAL_WALL)) {
+          moves.push_back({ player, PLACE_HORIZONAL_WALL, centerPoint(center) });
+        }
+      }
+    }
+
+    Undo doMove(const Move& move) {
+      ARC_ASSERT(move.player == _currentPlayer);
+      const Undo undo = { move, _cells[move.player] };
+      switch (move.type) {
+      case MOVE_PIECE:
+        _cells[move.player] = Geometry::neighbour(_cells[move.player], move.info.pieceMoveDirection);
+        break;
+      case JUMP_PIECE:
+        _cells[move.player] = static_cast<int8_t>(cellOf(move.info.jumpDestination));
+        break;
+      case PLACE_HORIZONAL_WALL:
+        _horizontal |= 1ULL << centerOf(move.info.wallCenter);
+        --_walls[move.player];
+        break;
+      case PLACE_VERTICAL_WALL:
+        _vertical |= 1ULL << centerOf(move.info.wallCenter);
+        --_walls[move.player];
+        break;
+      }
+      _currentPlayer = opponentOf(_currentPlayer);
+      return undo;
+    }
+
+    void undoMove(const Undo& undo) {
+      const Move& move = undo.move;
+      _currentPlayer = move.player;
+      _cells[move.player] = undo.previousCell;
+      if (move.type == PLACE_HORIZONAL_WALL) {
+        _horizontal &= ~(1ULL << centerOf(move.info.wallCenter));
+        ++_walls[move.player];
+      }
+      else if (move.type == PLACE_VERTICAL_WALL) {
+        _vertical &= ~(1ULL << centerOf(move.info.wallCenter));
+        ++_walls[move.player];
+      }
+    }
+
+    static inline Point point(int cell) {
+      return Geometry::point(cell);
+    }
+    static inline int cellOf(Point point) {
+      return point.x() + point.y() * SIZE;
+    }
+    static inline Point centerPoint(int center) {
+      return Point(static_cast<int8_t>(center % WALL_CENTERS_PER_ROW), static_cast<int8_t>(center / WALL_CENTERS_PER_ROW));
+    }
+    static inline int centerOf(Point point) {
+      return point.x() + point.y() * WALL_CENTERS_PER_ROW;
+    }
+  private:
+    inline bool wallKeepsPathsOpen(const VariantMovement<SIZE>& current, int center, MoveType type) const {
+      typedef VariantCells<SIZE> Cells;
+      VariantMovement<SIZE> withWall = current;
+      withWall.addWall(center, type);
+      return withWall.canReach(_cells[PLAYER_ONE], Cells::goalCells(PLAYER_ONE))
+        && withWall.canReach(_cells[PLAYER_TWO], Cells::goalCells(PLAYER_TWO));
+    }
+
+    uint64_t _horizontal;
+    uint64_t _vertical;
+    int8_t _cells[2];
+    int8_t _walls[2];
+    Player _currentPlayer;
+  };
+}
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "Board.hpp"
+#include "CellMask.hpp"
+#include "Variant.hpp"
+
+namespace Quoridor {
+
+  // Fixed size lookup table that can be built by the compiler.
+  template <typename T, int N>
+  struct ConstTable {
+    inline constexpr const T& operator[](int index) const {
+      return values[index];
+    }
+
+    T values[N];
+  };
+
+  // Entries of the geometry tables, written as single expression functions so that older compilers
+  // can evaluate them at compile time too.
+  namespace VariantTables {
+    const int8_t NO_CELL = -1;
+
+    constexpr int stepX(int direction) {
+      return direction == LEFT ? -1 : (direction == RIGHT ? 1 : 0);
+    }
+    constexpr int stepY(int direction) {
+      return direction == UP ? -1 : (direction == DOWN ? 1 : 0);
+    }
+    template <int SIZE>
+    constexpr bool isOnBoard(int x, int y) {
+      return x >= 0 && x < SIZE && y >= 0 && y < SIZE;
+    }
+    template <int SIZE>
+    constexpr int8_t neighbour(int cell, int direction) {
+      return isOnBoard<SIZE>(cell % SIZE + stepX(direction), cell / SIZE + stepY(direction))
+        ? static_cast<int8_t>(cell + stepX(direction) + stepY(direction) * SIZE)
+        : NO_CELL;
+    }
+    template <int SIZE>
+    constexpr uint8_t onBoardDirections(int cell) {
+      return static_cast<uint8_t>((neighbour<SIZE>(cell, UP) != NO_CELL ? 1 << UP : 0)
+        | (neighbour<SIZE>(cell, DOWN) != NO_CELL ? 1 << DOWN : 0)
+        | (neighbour<SIZE>(cell, LEFT) != NO_CELL ? 1 << LEFT : 0)
+        | (neighbour<SIZE>(cell, RIGHT) != NO_CELL ? 1 << RIGHT : 0));
+    }
+    template <int SIZE>
+    constexpr uint64_t centerBit(int x, int y) {
+      return x < 0 || x >= SIZE - 1 || y < 0 || y >= SIZE - 1 ? 0 : 1ULL << (x + y * (SIZE - 1));
+    }
+    // A wall center sits at the bottom right corner of the square with the same coordinates.
+    template <int SIZE>
+    constexpr uint64_t edgeBlockers(int x, int y, int direction) {
+      return direction == UP ? centerBit<SIZE>(x - 1, y - 1) | centerBit<SIZE>(x, y - 1)
+        : direction == DOWN ? centerBit<SIZE>(x - 1, y) | centerBit<SIZE>(x, y)
+        : direction == LEFT ? centerBit<SIZE>(x - 1, y - 1) | centerBit<SIZE>(x - 1, y)
+        : centerBit<SIZE>(x, y - 1) | centerBit<SIZE>(x, y);
+    }
+    template <int SIZE>
+    constexpr uint64_t centerColumn(int x, int y = 0) {
+      return y == SIZE - 1 ? 0 : centerBit<SIZE>(x, y) | centerColumn<SIZE>(x, y + 1);
+    }
+
+    // Square masks are built one 64 bit word at a time, word 0 for the low half of the CellMask.
+    constexpr uint64_t lowBits(int count) {
+      return count <= 0 ? 0 : (count >= 64 ? ~0ULL : (1ULL << count) - 1);
+    }
+    constexpr uint64_t cellWord(int cell, int word) {
+      return cell / 64 == word ? 1ULL << (cell % 64) : 0;
+    }
+    template <int SIZE>
+    constexpr uint64_t rowWord(int y, int word, int x = 0) {
+      return x == SIZE ? 0 : cellWord(x + y * SIZE, word) | rowWord<SIZE>(y, word, x + 1);
+    }
+    template <int SIZE>
+    constexpr uint64_t columnWord(int x, int word, int y = 0) {
+      return y == SIZE ? 0 : cellWord(x + y * SIZE, word) | columnWord<SIZE>(x, word, y + 1);
+    }
+    // Squares a step in the direction would leave the board from.
+    template <int SIZE>
+    constexpr uint64_t edgeWord(int direction, int word) {
+      return direction == UP ? rowWord<SIZE>(0, word)
+        : direction == DOWN ? rowWord<SIZE>(SIZE - 1, word)
+        : direction == LEFT ? columnWord<SIZE>(0, word)
+        : columnWord<SIZE>(SIZE - 1, word);
+    }
+    template <int SIZE>
+    constexpr int centerCell(int center) {
+      return center % (SIZE - 1) + center / (SIZE - 1) * SIZE;
+    }
+    // Corners are numbered x + y * (SIZE + 1), and wall center (x, y) is corner (x + 1, y + 1).
+    template <int SIZE>
+    constexpr bool isBorderCorner(int corner) {
+      return corner % (SIZE + 1) == 0 || corner % (SIZE + 1) == SIZE || corner / (SIZE + 1) == 0 || corner / (SIZE + 1) == SIZE;
+    }
+    template <int SIZE>
+    constexpr uint64_t borderWord(int word, int corner = 0) {
+      return corner == (SIZE + 1) * (SIZE + 1) ? 0
+        : (isBorderCorner<SIZE>(corner) ? cellWord(corner, word) : 0) | borderWord<SIZE>(word, corner + 1);
+    }
+    // The three corners a wall runs through, the first being its left or top end.
+    constexpr uint64_t wallCornersWord(int firstCorner, int step, int word) {
+      return cellWord(firstCorner, word) | cellWord(firstCorner + step, word) | cellWord(firstCorner + 2 * step, word);
+    }
+    template <int SIZE>
+    constexpr int centerCorner(int center) {
+      return center % (SIZE - 1) + 1 + (center / (SIZE - 1) + 1) * (SIZE + 1);
+    }
+
+    template <int SIZE>
+    constexpr CellMask rowCells(int y) {
+      return CellMask(rowWord<SIZE>(y, 0), rowWord<SIZE>(y, 1));
+    }
+    template <int SIZE>
+    constexpr CellMask onBoardCells(int direction) {
+      return CellMask(lowBits(SIZE * SIZE) & ~edgeWord<SIZE>(direction, 0),
+        lowBits(SIZE * SIZE - 64) & ~edgeWord<SIZE>(direction, 1));
+    }
+    constexpr CellMask wallCells(int cell, int step) {
+      return CellMask(cellWord(cell, 0) | cellWord(cell + step, 0), cellWord(cell, 1) | cellWord(cell + step, 1));
+    }
+    constexpr CellMask wallCorners(int corner, int step) {
+      return CellMask(wallCornersWord(corner - step, step, 0), wallCornersWord(corner - step, step, 1));
+    }
+
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<int8_t, SIZE * SIZE * DIRECTION_COUNT> neighbours(std::index_sequence<I...>) {
+      return{ { neighbour<SIZE>(I / DIRECTION_COUNT, I % DIRECTION_COUNT)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<uint8_t, SIZE * SIZE> onBoardDirections(std::index_sequence<I...>) {
+      return{ { onBoardDirections<SIZE>(I)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<uint64_t, SIZE * SIZE * DIRECTION_COUNT> edgeBlockers(std::index_sequence<I...>) {
+      return{ { edgeBlockers<SIZE>((I / DIRECTION_COUNT) % SIZE, (I / DIRECTION_COUNT) / SIZE, I % DIRECTION_COUNT)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<CellMask, sizeof...(I)> rowCells(std::index_sequence<I...>) {
+      return{ { rowCells<SIZE>(I)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<CellMask, DIRECTION_COUNT> onBoardCells(std::index_sequence<I...>) {
+      return{ { onBoardCells<SIZE>(I)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<CellMask, sizeof...(I)> horizontalWallCells(std::index_sequence<I...>) {
+      return{ { wallCells(centerCell<SIZE>(I), 1)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<CellMask, sizeof...(I)> verticalWallCells(std::index_sequence<I...>) {
+      return{ { wallCells(centerCell<SIZE>(I), SIZE)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<CellMask, sizeof...(I)> horizontalWallCorners(std::index_sequence<I...>) {
+      return{ { wallCorners(centerCorner<SIZE>(I), 1)... } };
+    }
+    template <int SIZE, size_t... I>
+    constexpr ConstTable<CellMask, sizeof...(I)> verticalWallCorners(std::index_sequence<I...>) {
+      return{ { wallCorners(centerCorner<SIZE>(I), SIZE + 1)... } };
+    }
+  }
+
+  // Step tables for any board size, built by the compiler rather than at startup. BoardGeometry reads
+  // the 9x9 ones.
+  template <int SIZE>
+  struct VariantGeometry {
+    static const int CELL_COUNT = SIZE * SIZE;
+    static const int WALL_CENTERS_PER_ROW = SIZE - 1;
+
+    typedef ConstTable<int8_t, CELL_COUNT * DIRECTION_COUNT> NeighbourTable;
+    typedef ConstTable<uint8_t, CELL_COUNT> DirectionTable;
+    typedef ConstTable<uint64_t, CELL_COUNT * DIRECTION_COUNT> BlockerTable;
+
+    static constexpr NeighbourTable NEIGHBOURS =
+      VariantTables::neighbours<SIZE>(std::make_index_sequence<CELL_COUNT * DIRECTION_COUNT>());
+    static constexpr DirectionTable ON_BOARD_DIRECTIONS =
+      VariantTables::onBoardDirections<SIZE>(std::make_index_sequence<CELL_COUNT>());
+    static constexpr BlockerTable EDGE_BLOCKERS =
+      VariantTables::edgeBlockers<SIZE>(std::make_index_sequence<CELL_COUNT * DIRECTION_COUNT>());
+
+    static constexpr uint64_t ALL_CENTERS = WALL_CENTERS_PER_ROW == 8
+      ? ~0ULL : (1ULL << (WALL_CENTERS_PER_ROW * WALL_CENTERS_PER_ROW)) - 1;
+    static constexpr uint64_t FIRST_CENTER_COLUMN = VariantTables::centerColumn<SIZE>(0);
+    static constexpr uint64_t LAST_CENTER_COLUMN = VariantTables::centerColumn<SIZE>(WALL_CENTERS_PER_ROW - 1);
+
+    // Square one step in the given direction, or NO_CELL when that would leave the board.
+    static inline int8_t neighbour(int cell, int direction) {
+      return NEIGHBOURS[cell * DIRECTION_COUNT + direction];
+    }
+    static inline uint8_t onBoardDirections(int cell) {
+      return ON_BOARD_DIRECTIONS[cell];
+    }
+    static inline uint64_t edgeBlockers(int cell, int direction) {
+      return EDGE_BLOCKERS[cell * DIRECTION_COUNT + direction];
+    }
+    // The two directions at right angles to the given one, used for diagonal jumps.
+    static inline int perpendicular(int direction, int which) {
+      return (direction < LEFT ? LEFT : UP) + which;
+    }
+    static inline Point point(int cell) {
+      return Point(static_cast<int8_t>(cell % SIZE), static_cast<int8_t>(cell / SIZE));
+    }
+  };
+
+  template <int SIZE>
+  constexpr typename VariantGeometry<SIZE>::NeighbourTable VariantGeometry<SIZE>::NEIGHBOURS;
+  template <int SIZE>
+  constexpr typename VariantGeometry<SIZE>::DirectionTable VariantGeometry<SIZE>::ON_BOARD_DIRECTIONS;
+  template <int SIZE>
+  constexpr typename VariantGeometry<SIZE>::BlockerTable VariantGeometry<SIZE>::EDGE_BLOCKERS;
+  template <int SIZE>
+  constexpr uint64_t VariantGeometry<SIZE>::ALL_CENTERS;
+  template <int SIZE>
+  constexpr uint64_t VariantGeometry<SIZE>::FIRST_CENTER_COLUMN;
+  template <int SIZE>
+  constexpr uint64_t VariantGeometry<SIZE>::LAST_CENTER_COLUMN;
+
+  // Square and corner masks for any board size, built by the compiler like VariantGeometry. Corners
+  // of squares, where wall ends meet, are numbered x + y * (SIZE + 1), so wall center (x, y) is corner
+  // (x + 1, y + 1).
+  template <int SIZE>
+  struct VariantCells {
+    static const int CELL_COUNT = SIZE * SIZE;
+    static const int WALL_CENTER_COUNT = (SIZE - 1) * (SIZE - 1);
+    static_assert((SIZE + 1) * (SIZE + 1) <= 128, "Corners fit a CellMask");
+
+    typedef ConstTable<CellMask, SIZE> RowTable;
+    typedef ConstTable<CellMask, 2> GoalTable;
+    typedef ConstTable<CellMask, DIRECTION_COUNT> DirectionTable;
+    typedef ConstTable<CellMask, WALL_CENTER_COUNT> CenterTable;
+
+    static constexpr CellMask ALL_CELLS = CellMask(VariantTables::lowBits(CELL_COUNT), VariantTables::lowBits(CELL_COUNT - 64));
+    static constexpr RowTable ROW_CELLS = VariantTables::rowCells<SIZE>(std::make_index_sequence<SIZE>());
+    static constexpr GoalTable GOAL_CELLS = { { VariantTables::rowCells<SIZE>(SIZE - 1), VariantTables::rowCells<SIZE>(0) } };
+    static constexpr DirectionTable ON_BOARD_CELLS =
+      VariantTables::onBoardCells<SIZE>(std::make_index_sequence<DIRECTION_COUNT>());
+    static constexpr CenterTable HORIZONTAL_WALL_CELLS =
+      VariantTables::horizontalWallCells<SIZE>(std::make_index_sequence<WALL_CENTER_COUNT>());
+    static constexpr CenterTable VERTICAL_WALL_CELLS =
+      VariantTables::verticalWallCells<SIZE>(std::make_index_sequence<WALL_CENTER_COUNT>());
+    static constexpr CellMask BORDER_CORNERS = CellMask(VariantTables::borderWord<SIZE>(0), VariantTables::borderWord<SIZE>(1));
+    static constexpr CenterTable HORIZONTAL_WALL_CORNERS =
+      VariantTables::horizontalWallCorners<SIZE>(std::make_index_sequence<WALL_CENTER_COUNT>());
+    static constexpr CenterTable VERTICAL_WALL_CORNERS =
+      VariantTables::verticalWallCorners<SIZE>(std::make_index_sequence<WALL_CENTER_COUNT>());
+
+    static inline const CellMask& allCells() {
+      return ALL_CELLS;
+    }
+    static inline const CellMask& rowCells(int y) {
+      return ROW_CELLS[y];
+    }
+    // The row a player has to reach to win.
+    static inline const CellMask& goalCells(Player player) {
+      return GOAL_CELLS[player];
+    }
+    // Squares from which a step in the direction stays on the board.
+    static inline const CellMask& onBoardCells(int direction) {
+      return ON_BOARD_CELLS[direction];
+    }
+    // The two squares whose bottom edge a horizontal wall on this center covers, ie. (x, y) and (x + 1, y).
+    static inline const CellMask& horizontalWallCells(int center) {
+      return HORIZONTAL_WALL_CELLS[center];
+    }
+    // The two squares whose right edge a vertical wall on this center covers, ie. (x, y) and (x, y + 1).
+    static inline const CellMask& verticalWallCells(int center) {
+      return VERTICAL_WALL_CELLS[center];
+    }
+    // Corners on the edge of the board.
+    static inline const CellMask& borderCorners() {
+      return BORDER_CORNERS;
+    }
+    // The three corners a wall on this center runs through.
+    static inline const CellMask& horizontalWallCorners(int center) {
+      return HORIZONTAL_WALL_CORNERS[center];
+    }
+    static inline const CellMask& verticalWallCorners(int center) {
+      return VERTICAL_WALL_CORNERS[center];
+    }
+  };
+
+  template <int SIZE>
+  constexpr CellMask VariantCells<SIZE>::ALL_CELLS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::RowTable VariantCells<SIZE>::ROW_CELLS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::GoalTable VariantCells<SIZE>::GOAL_CELLS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::DirectionTable VariantCells<SIZE>::ON_BOARD_CELLS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::CenterTable VariantCells<SIZE>::HORIZONTAL_WALL_CELLS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::CenterTable VariantCells<SIZE>::VERTICAL_WALL_CELLS;
+  template <int SIZE>
+  constexpr CellMask VariantCells<SIZE>::BORDER_CORNERS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::CenterTable VariantCells<SIZE>::HORIZONTAL_WALL_CORNERS;
+  template <int SIZE>
+  constexpr typename VariantCells<SIZE>::CenterTable VariantCells<SIZE>::VERTICAL_WALL_CORNERS;
+
+  // For each direction, the squares a piece can step from in that direction without leaving the
+  // board or crossing a wall. Reachability is then a flood fill over all squares at once.
+  template <int SIZE>
+  class VariantMovement {
+  public:
+    VariantMovement(uint64_t horizontalWalls, uint64_t verticalWalls) {
+      typedef VariantCells<SIZE> Cells;
+      // A horizontal wall covers the bottom edge of its own square and the one to the right, the squares
+      // below those lose their top edge. Vertical walls are the same turned sideways.
+      const CellMask horizontal = centersToCells(horizontalWalls);
+      const CellMask vertical = centersToCells(verticalWalls);
+      const CellMask blockedDown = horizontal | (horizontal << 1);
+      const CellMask blockedRight = vertical | (vertical << SIZE);
+
+      _open[UP] = Cells::onBoardCells(UP) & ~(blockedDown << SIZE);
+      _open[DOWN] = Cells::onBoardCells(DOWN) & ~blockedDown;
+      _open[LEFT] = Cells::onBoardCells(LEFT) & ~(blockedRight << 1);
+      _open[RIGHT] = Cells::onBoardCells(RIGHT) & ~blockedRight;
+    }
+
+    // Closes the edges covered by a wall that is not on the board yet.
+    void addWall(int center, MoveType type) {
+      if (type == PLACE_VERTICAL_WALL) {
+        const CellMask& covered = VariantCells<SIZE>::verticalWallCells(center);
+        _open[RIGHT] &= ~covered;
+        _open[LEFT] &= ~(covered << 1);
+      }
+      else {
+        const CellMask& covered = VariantCells<SIZE>::horizontalWallCells(center);
+        _open[DOWN] &= ~covered;
+        _open[UP] &= ~(covered << SIZE);
+      }
+    }
+
+    inline const CellMask& open(int direction) const {
+      return _open[direction];
+    }
+
+    // Squares one step away from any of the given squares, which may include the squares themselves.
+    CellMask step(const CellMask& from) const {
+      // The open masks never contain a square on the edge in the direction being stepped so none of
+      // these shifts can wrap around to the other side of the board.
+      return ((from & _open[UP]) >> SIZE)
+        | ((from & _open[DOWN]) << SIZE)
+        | ((from & _open[LEFT]) >> 1)
+        | ((from & _open[RIGHT]) << 1);
+    }
+    // Every square reachable from the starting squares. Stops early, returning a partial fill, as soon
+    // as any square in target has been reached.
+    CellMask floodFill(const CellMask& from, const CellMask& target) const {
+      CellMask reached = from;
+      while (true) {
+        const CellMask next = reached | step(reached);
+        if (next == reached || (next & target).any()) {
+          return next;
+        }
+        reached = next;
+      }
+    }
+    bool canReach(int cell, const CellMask& target) const {
+      const CellMask start = CellMask::cell(cell);
+      return (start & target).any() || (floodFill(start, target) & target).any();
+    }
+  private:
+    // Moves every wall center bit onto the square with the same coordinates.
+    static CellMask centersToCells(uint64_t centers) {
+      const int CENTERS_PER_ROW = SIZE - 1;
+      const uint64_t ROW_MASK = (1ULL << CENTERS_PER_ROW) - 1;
+      uint64_t low = 0;
+      uint64_t high = 0;
+      for (int row = 0; row < CENTERS_PER_ROW; ++row) {
+        const uint64_t rowBits = (centers >> (row * CENTERS_PER_ROW)) & ROW_MASK;
+        const int offset = row * SIZE;
+        if (offset < 64) {
+          low |= rowBits << offset;
+          if (offset > 0) {
+            high |= rowBits >> (64 - offset);
+          }
+        }
+        else {
+          high |= rowBits << (offset - 64);
+        }
+      }
+      return{ low, high };
+    }
+
+    CellMask _open[DIRECTION_COUNT];
+  };
+
+  // The movement rules of the game on walls given as center masks, shared by Board and VariantBoard
+  // so that both generate the same moves.
+  template <int SIZE>
+  struct VariantRules {
+    typedef VariantGeometry<SIZE> Geometry;
+    static const int WALL_CENTERS_PER_ROW = SIZE - 1;
+
+    // Bit set of the directions a piece on the given square can step in without leaving the board
+    // or crossing a wall.
+    static inline uint8_t openDirections(int cell, uint64_t horizontal, uint64_t vertical) {
+      uint8_t open = Geometry::onBoardDirections(cell);
+      open &= ~(((horizontal & Geometry::edgeBlockers(cell, UP)) != 0) << UP);
+      open &= ~(((horizontal & Geometry::edgeBlockers(cell, DOWN)) != 0) << DOWN);
+      open &= ~(((vertical & Geometry::edgeBlockers(cell, LEFT)) != 0) << LEFT);
+      open &= ~(((vertical & Geometry::edgeBlockers(cell, RIGHT)) != 0) << RIGHT);
+      return open;
+    }
+
+    // Centers where a horizontal wall would not collide with one already placed. It spans its center
+    // and the centers to the left and right, so it collides with any wall on the same center or a
+    // horizontal wall one center over on the same row.
+    static inline uint64_t availableHorizontalCenters(uint64_t horizontal, uint64_t vertical) {
+      const uint64_t blocked = horizontal | vertical
+        | ((horizontal << 1) & ~Geometry::FIRST_CENTER_COLUMN)
+        | ((horizontal >> 1) & ~Geometry::LAST_CENTER_COLUMN);
+      return ~blocked & Geometry::ALL_CENTERS;
+    }
+    // Same as above but vertical walls extend up and down, which is a full row of centers away.
+    static inline uint64_t availableVerticalCenters(uint64_t horizontal, uint64_t vertical) {
+      const uint64_t blocked = horizontal | vertical
+        | (vertical << WALL_CENTERS_PER_ROW)
+        | (vertical >> WALL_CENTERS_PER_ROW);
+      return ~blocked & Geometry::ALL_CENTERS;
+    }
+
+    // Appends the steps and jumps of a pawn on the given square with the other pawn on opponentCell.
+    template <typename MoveListType>
+    static void availablePieceMoves(Player player, int cell, int opponentCell, uint64_t horizontal, uint64_t vertical,
+      MoveListType& moves) {
+      const uint8_t open = openDirections(cell, horizontal, vertical);
+      for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+        if ((open & (1 << direction)) == 0) {
+          continue;
+        }
+        const int next = Geometry::neighbour(cell, direction);
+        if (next != opponentCell) {
+          moves.push_back({ player, static_cast<Direction>(direction) });
+          continue;
+        }
+
+        // The opponent is in the way. Jump straight over them if nothing is behind them, otherwise
+        // step diagonally to either side of them.
+        const uint8_t openFromOpponent = openDirections(next, horizontal, vertical);
+        if (openFromOpponent & (1 << direction)) {
+          moves.push_back({ player, JUMP_PIECE, Geometry::point(Geometry::neighbour(next, direction)) });
+          continue;
+        }
+        for (int side = 0; side < 2; ++side) {
+          const int sideDirection = Geometry::perpendicular(direction, side);
+          if (openFromOpponent & (1 << sideDirection)) {
+            moves.push_back({ player, JUMP_PIECE, Geometry::point(Geometry::neighbour(next, sideDirection)) });
+          }
+        }
+      }
+    }
+  };
+}
@@ -0,0 +1,37 @@
+#include "pch.h"
+
+#include "Util/Random.hpp"
+#include "Zobrist.hpp"
+
+using namespace std;
+using namespace Quoridor;
+
+const ZobristKeys& ZobristKeys::instance() {
+  static const ZobristKeys keys;
+  return keys;
+}
+
+// Seeded with a constant so keys, and anything saved with them, are stable between runs.
+static uint64_t nextKey(uint64_t& state) {
+  return Random::splitMix64(state);
+}
+
+ZobristKeys::ZobristKeys() {
+  uint64_t state = 0x51A7E0F0D1C0FFEEULL;
+  for (int player = 0; player < 2; ++player) {
+    for (int cell = 0; cell < CELL_COUNT; ++cell) {
+      _pawns[player][cell] = nextKey(state);
+    }
+  }
+  for (int orientation = 0; orientation < 2; ++orientation) {
+    for (int center = 0; center < WALL_CENTER_COUNT; ++center) {
+      _walls[orientation][center] = nextKey(state);
+    }
+  }
+  for (int player = 0; player < 2; ++player) {
+    for (int count = 0; count <= STARTING_WALL_COUNTS; ++count) {
+      _wallCounts[player][count] = nextKey(state);
+    }
+  }
+  _playerTwoToMove = nextKey(state);
+}
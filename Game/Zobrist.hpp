@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Board.hpp"
+
+namespace Quoridor {
+
+  // Random keys for Zobrist hashing of board states. A position's key is the XOR of the keys for
+  // each pawn square, each wall, each player's remaining wall count and the side to move, so making a
+  // move only has to XOR out what changed and XOR in the replacement.
+  class ZobristKeys final {
+  public:
+    static const ZobristKeys& instance();
+
+    inline uint64_t pawn(Player player, int cell) const {
+      return _pawns[player][cell];
+    }
+    inline uint64_t wall(MoveType orientation, int center) const {
+      return _walls[orientation == PLACE_VERTICAL_WALL ? 1 : 0][center];
+    }
+    inline uint64_t wallCount(Player player, int count) const {
+      return _wallCounts[player][count];
+    }
+    // Present in the key whenever it is player two's turn.
+    inline uint64_t playerTwoToMove() const {
+      return _playerTwoToMove;
+    }
+  private:
+    ZobristKeys();
+    ZobristKeys(const ZobristKeys&) = delete;
+    ZobristKeys& operator=(const ZobristKeys&) = delete;
+
+    uint64_t _pawns[2][CELL_COUNT];
+    uint64_t _walls[2][WALL_CENTER_COUNT];
+    uint64_t _wallCounts[2][STARTING_WALL_COUNTS + 1];
+    uint64_t _playerTwoToMove;
+  };
+}
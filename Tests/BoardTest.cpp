@@ -6,6 +6,8 @@
 #include <string>
 
 #include "Board.hpp"
+#include "Pathing.hpp"
+#include "Symmetry.hpp"
 
 using namespace Quoridor;
 using namespace std;
@@ -79,6 +81,22 @@ static vector<Move> allPossibleWallMoves(Player player) {
   return allPossible;
 }
 
+static vector<Move> sortedMoves(const Board& board, Player player) {
+  MoveList moves;
+  board.availableMoves(player, moves);
+  vector<Move> pieceMoves;
+  copy_if(begin(moves), end(moves), back_inserter(pieceMoves), [](const Move& m) {
+    return m.type == MOVE_PIECE || m.type == JUMP_PIECE;
+  });
+  sort(begin(pieceMoves), end(pieceMoves));
+  return pieceMoves;
+}
+
+static vector<Move> sortedMoves(vector<Move> moves) {
+  sort(begin(moves), end(moves));
+  return moves;
+}
+
 namespace Tests
 {		
   TEST_CLASS(BoardTest)
@@ -123,7 +141,6 @@ namespace Tests
 
       // Check initial possible moves.
       // P1 can move left, right and down. p2 can move up, left and right. Both players can place a wall anywhere that is legal.
-      defaultBoard.availableMoves(PLAYER_ONE);
       vector<Move> playerOneExpectedInitialMoves {
         { PLAYER_ONE, LEFT },
         { PLAYER_ONE, RIGHT },
@@ -140,8 +157,11 @@ namespace Tests
       copy(begin(p1WallMoves), end(p1WallMoves), back_inserter(playerOneExpectedInitialMoves));
       copy(begin(p2WallMoves), end(p2WallMoves), back_inserter(playerTwoExpectedInitialMoves));
 
-      auto actualPlayerOneMoves = defaultBoard.availableMoves(PLAYER_ONE);
-      auto actualPlayerTwoMoves = defaultBoard.availableMoves(PLAYER_TWO);
+      MoveList moves;
+      defaultBoard.availableMoves(PLAYER_ONE, moves);
+      vector<Move> actualPlayerOneMoves(begin(moves), end(moves));
+      defaultBoard.availableMoves(PLAYER_TWO, moves);
+      vector<Move> actualPlayerTwoMoves(begin(moves), end(moves));
 
       sort(begin(actualPlayerOneMoves), end(actualPlayerOneMoves));
       sort(begin(actualPlayerTwoMoves), end(actualPlayerTwoMoves));
@@ -168,5 +188,332 @@ namespace Tests
       Assert::AreEqual(actualWalls, expectedWalls);
     }
 
+    TEST_METHOD(TestWallCollisions) {
+      WallsState state;
+      state.placeWall(3, 3, PLACE_HORIZONAL_WALL);
+      state.placeWall(0, 5, PLACE_VERTICAL_WALL);
+      MoveList moves;
+      state.availableWallPlacements(PLAYER_ONE, moves);
+      auto isAvailable = [&moves](MoveType type, int8_t x, int8_t y) {
+        return find(begin(moves), end(moves), Move{ PLAYER_ONE, type, { x, y } }) != end(moves);
+      };
+
+      // nothing can go on an occupied center
+      Assert::IsFalse(isAvailable(PLACE_HORIZONAL_WALL, 3, 3));
+      Assert::IsFalse(isAvailable(PLACE_VERTICAL_WALL, 3, 3));
+      // horizontal walls overlap to the left and right, vertical walls overlap above and below
+      Assert::IsFalse(isAvailable(PLACE_HORIZONAL_WALL, 2, 3));
+      Assert::IsFalse(isAvailable(PLACE_HORIZONAL_WALL, 4, 3));
+      Assert::IsTrue(isAvailable(PLACE_VERTICAL_WALL, 2, 3));
+      Assert::IsTrue(isAvailable(PLACE_HORIZONAL_WALL, 3, 2));
+      Assert::IsFalse(isAvailable(PLACE_VERTICAL_WALL, 0, 4));
+      Assert::IsFalse(isAvailable(PLACE_VERTICAL_WALL, 0, 6));
+      Assert::IsTrue(isAvailable(PLACE_HORIZONAL_WALL, 0, 4));
+      // walls on the edge of the board do not wrap around to the next row
+      Assert::IsTrue(isAvailable(PLACE_HORIZONAL_WALL, 7, 4));
+      Assert::IsTrue(isAvailable(PLACE_HORIZONAL_WALL, 1, 5));
+
+      // each wall takes its own center in both orientations plus the two overlapping centers
+      Assert::AreEqual(moves.size(), MAX_POSSIBLE_WALL_POSITIONS - 8);
+    }
+
+    TEST_METHOD(TestDoAndUndoMove) {
+      Board board;
+      Assert::AreEqual(board.currentPlayer(), PLAYER_ONE);
+
+      auto pieceUndo = board.doMove({ PLAYER_ONE, DOWN });
+      Assert::AreEqual(board.playerPosition(PLAYER_ONE), Point(4, 1));
+      Assert::AreEqual(board.currentPlayer(), PLAYER_TWO);
+
+      auto wallUndo = board.doMove({ PLAYER_TWO, PLACE_VERTICAL_WALL, { 2, 6 } });
+      Assert::AreEqual(board.wallCount(PLAYER_TWO), 9);
+      Assert::AreEqual(board.walls(), vector<Wall>{ { 2, 6, true } });
+      Assert::AreEqual(board.currentPlayer(), PLAYER_ONE);
+
+      auto jumpUndo = board.doMove({ PLAYER_ONE, JUMP_PIECE, { 4, 3 } });
+      Assert::AreEqual(board.playerPosition(PLAYER_ONE), Point(4, 3));
+
+      board.undoMove(jumpUndo);
+      Assert::AreEqual(board.playerPosition(PLAYER_ONE), Point(4, 1));
+      Assert::AreEqual(board.currentPlayer(), PLAYER_ONE);
+
+      board.undoMove(wallUndo);
+      Assert::AreEqual(board.wallCount(PLAYER_TWO), 10);
+      Assert::AreEqual(board.walls(), vector<Wall>{});
+      Assert::AreEqual(board.currentPlayer(), PLAYER_TWO);
+
+      board.undoMove(pieceUndo);
+      Assert::AreEqual(board.playerPosition(PLAYER_ONE), Point(4, 0));
+      Assert::AreEqual(board.currentPlayer(), PLAYER_ONE);
+    }
+
+    TEST_METHOD(TestWallsBlockPieceMoves) {
+      Board board;
+      board.doMove({ PLAYER_ONE, PLACE_VERTICAL_WALL, { 4, 0 } });
+      Assert::AreEqual(sortedMoves(board, PLAYER_ONE), sortedMoves({ { PLAYER_ONE, LEFT }, { PLAYER_ONE, DOWN } }));
+      board.doMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 3, 0 } });
+      Assert::AreEqual(sortedMoves(board, PLAYER_ONE), sortedMoves({ { PLAYER_ONE, LEFT } }));
+    }
+
+    TEST_METHOD(TestJumpMoves) {
+      Board board;
+      for (int i = 0; i < 3; ++i) {
+        board.doMove({ PLAYER_ONE, DOWN });
+        board.doMove({ PLAYER_TWO, UP });
+      }
+      board.doMove({ PLAYER_ONE, DOWN });
+      Assert::AreEqual(board.playerPosition(PLAYER_ONE), Point(4, 4));
+      Assert::AreEqual(board.playerPosition(PLAYER_TWO), Point(4, 5));
+
+      // nothing behind player one so player two jumps straight over
+      Assert::AreEqual(sortedMoves(board, PLAYER_TWO), sortedMoves({
+        { PLAYER_TWO, LEFT },
+        { PLAYER_TWO, RIGHT },
+        { PLAYER_TWO, DOWN },
+        { PLAYER_TWO, JUMP_PIECE, { 4, 3 } },
+      }));
+
+      // a wall behind player two forces player one to go around diagonally
+      board.doMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 4, 5 } });
+      Assert::AreEqual(sortedMoves(board, PLAYER_ONE), sortedMoves({
+        { PLAYER_ONE, LEFT },
+        { PLAYER_ONE, RIGHT },
+        { PLAYER_ONE, UP },
+        { PLAYER_ONE, JUMP_PIECE, { 3, 5 } },
+        { PLAYER_ONE, JUMP_PIECE, { 5, 5 } },
+      }));
+
+      // and a wall beside player two takes away that diagonal
+      board.doMove({ PLAYER_ONE, PLACE_VERTICAL_WALL, { 3, 5 } });
+      Assert::AreEqual(sortedMoves(board, PLAYER_ONE), sortedMoves({
+        { PLAYER_ONE, LEFT },
+        { PLAYER_ONE, RIGHT },
+        { PLAYER_ONE, UP },
+        { PLAYER_ONE, JUMP_PIECE, { 5, 5 } },
+      }));
+    }
+
+    TEST_METHOD(TestWallsMustLeaveAPath) {
+      Board board;
+      WallsState walls;
+      const vector<Move> wallMoves = {
+        { PLAYER_ONE, PLACE_HORIZONAL_WALL, { 0, 0 } },
+        { PLAYER_TWO, PLACE_HORIZONAL_WALL, { 2, 0 } },
+        { PLAYER_ONE, PLACE_HORIZONAL_WALL, { 4, 0 } },
+        { PLAYER_TWO, PLACE_HORIZONAL_WALL, { 6, 0 } },
+      };
+      for (const Move& move : wallMoves) {
+        board.doMove(move);
+        walls.placeWall(move.info.wallCenter.x(), move.info.wallCenter.y(), move.type);
+      }
+
+      // Player one's only way out of the first row is through the last column, a vertical wall
+      // anywhere between them and it would trap them.
+      MoveList collisionFree;
+      walls.availableWallPlacements(PLAYER_ONE, collisionFree);
+      vector<Move> expected;
+      const Move trappingWalls[] = {
+        { PLAYER_ONE, PLACE_VERTICAL_WALL, { 5, 0 } },
+        { PLAYER_ONE, PLACE_VERTICAL_WALL, { 7, 0 } },
+      };
+      copy_if(begin(collisionFree), end(collisionFree), back_inserter(expected), [&trappingWalls](const Move& m) {
+        return find(begin(trappingWalls), end(trappingWalls), m) == end(trappingWalls);
+      });
+      Assert::AreEqual(expected.size() + 2, (size_t)collisionFree.size());
+
+      MoveList moves;
+      board.availableMoves(PLAYER_ONE, moves);
+      vector<Move> actual;
+      copy_if(begin(moves), end(moves), back_inserter(actual), [](const Move& m) {
+        return m.type == PLACE_HORIZONAL_WALL || m.type == PLACE_VERTICAL_WALL;
+      });
+      Assert::AreEqual(sortedMoves(actual), sortedMoves(expected));
+    }
+
+    TEST_METHOD(TestGoalDistances) {
+      Board board;
+      board.enableGoalDistances();
+      Assert::AreEqual(board.goalDistance(PLAYER_ONE), 8);
+      Assert::AreEqual(board.goalDistance(PLAYER_TWO), 8);
+
+      // a wall under player one makes both players walk around it
+      auto wallUndo = board.doMove({ PLAYER_ONE, PLACE_HORIZONAL_WALL, { 3, 0 } });
+      Assert::AreEqual(board.goalDistance(PLAYER_ONE), 9);
+      Assert::AreEqual(board.goalDistance(PLAYER_TWO), 9);
+      Assert::AreEqual(board.goalDistances().distance(PLAYER_TWO, 4), 0);
+      Assert::AreEqual(board.goalDistances().distance(PLAYER_TWO, 13), 2);
+
+      auto pieceUndo = board.doMove({ PLAYER_TWO, UP });
+      Assert::AreEqual(board.goalDistance(PLAYER_TWO), 8);
+
+      board.undoMove(pieceUndo);
+      board.undoMove(wallUndo);
+      Assert::AreEqual(board.goalDistance(PLAYER_ONE), 8);
+      Assert::AreEqual(board.goalDistance(PLAYER_TWO), 8);
+    }
+
+    TEST_METHOD(TestWallCutFilter) {
+      const BoardGeometry& geometry = BoardGeometry::instance();
+      WallsState walls;
+      auto filterFor = [&walls, &geometry]() {
+        WallCutFilter filter(walls);
+        const MovementMasks masks(walls);
+        filter.addRoute(masks, walls, cellIndex(4, 0), geometry.goalCells(PLAYER_ONE));
+        filter.addRoute(masks, walls, cellIndex(4, 8), geometry.goalCells(PLAYER_TWO));
+        return filter;
+      };
+
+      // a lone wall can touch the border at one end at most, so nothing can be cut off
+      auto emptyBoardFilter = filterFor();
+      for (int center = 0; center < WALL_CENTER_COUNT; ++center) {
+        Assert::IsFalse(emptyBoardFilter.mayDisconnect(center, PLACE_HORIZONAL_WALL));
+        Assert::IsFalse(emptyBoardFilter.mayDisconnect(center, PLACE_VERTICAL_WALL));
+      }
+
+      walls.placeWall(0, 0, PLACE_HORIZONAL_WALL);
+      walls.placeWall(2, 0, PLACE_HORIZONAL_WALL);
+      walls.placeWall(4, 0, PLACE_HORIZONAL_WALL);
+      walls.placeWall(6, 0, PLACE_HORIZONAL_WALL);
+      auto filter = filterFor();
+      Assert::IsTrue(filter.mayDisconnect(7, PLACE_VERTICAL_WALL));
+      // touches the row of walls but is nowhere near either route
+      Assert::IsFalse(filter.mayDisconnect(1, PLACE_VERTICAL_WALL));
+    }
+
+    TEST_METHOD(TestPackedBoard) {
+      Board board;
+      board.doMove({ PLAYER_ONE, PLACE_VERTICAL_WALL, { 2, 6 } });
+      board.doMove({ PLAYER_TWO, UP });
+      board.doMove({ PLAYER_ONE, DOWN });
+      board.doMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 7, 7 } });
+      board.doMove({ PLAYER_ONE, PLACE_HORIZONAL_WALL, { 0, 0 } });
+
+      const PackedBoard packed = board.pack();
+      Board unpacked(packed);
+      Assert::IsTrue(unpacked.pack() == packed);
+      Assert::AreEqual(unpacked.playerPosition(PLAYER_ONE), Point(4, 1));
+      Assert::AreEqual(unpacked.playerPosition(PLAYER_TWO), Point(4, 7));
+      Assert::AreEqual(unpacked.wallCount(PLAYER_ONE), 8);
+      Assert::AreEqual(unpacked.wallCount(PLAYER_TWO), 9);
+      Assert::AreEqual(unpacked.currentPlayer(), PLAYER_TWO);
+      auto expectedWalls = board.walls();
+      auto actualWalls = unpacked.walls();
+      sort(begin(expectedWalls), end(expectedWalls));
+      sort(begin(actualWalls), end(actualWalls));
+      Assert::AreEqual(actualWalls, expectedWalls);
+
+      // the same position reached in a different order packs the same
+      Board transposed;
+      transposed.doMove({ PLAYER_ONE, PLACE_HORIZONAL_WALL, { 0, 0 } });
+      transposed.doMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 7, 7 } });
+      transposed.doMove({ PLAYER_ONE, DOWN });
+      transposed.doMove({ PLAYER_TWO, UP });
+      transposed.doMove({ PLAYER_ONE, PLACE_VERTICAL_WALL, { 2, 6 } });
+      Assert::IsTrue(transposed.pack() == packed);
+      Assert::AreEqual(transposed.pack().hash(), packed.hash());
+      Assert::AreEqual(transposed.zobristKey(), board.zobristKey());
+      Assert::AreEqual(unpacked.zobristKey(), board.zobristKey());
+
+      Assert::IsTrue(Board().pack() != packed);
+    }
+
+    TEST_METHOD(TestZobristKeyUndo) {
+      Board board;
+      const uint64_t initialKey = board.zobristKey();
+      auto pieceUndo = board.doMove({ PLAYER_ONE, DOWN });
+      const uint64_t afterPieceKey = board.zobristKey();
+      Assert::AreNotEqual(afterPieceKey, initialKey);
+      auto wallUndo = board.doMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 3, 3 } });
+      Assert::AreNotEqual(board.zobristKey(), afterPieceKey);
+      board.undoMove(wallUndo);
+      Assert::AreEqual(board.zobristKey(), afterPieceKey);
+      board.undoMove(pieceUndo);
+      Assert::AreEqual(board.zobristKey(), initialKey);
+    }
+
+    TEST_METHOD(TestSymmetry) {
+      Board board;
+      board.doMove({ PLAYER_ONE, RIGHT });
+      board.doMove({ PLAYER_TWO, PLACE_VERTICAL_WALL, { 1, 2 } });
+
+      Board mirrored;
+      mirrored.doMove({ PLAYER_ONE, LEFT });
+      mirrored.doMove({ PLAYER_TWO, PLACE_VERTICAL_WALL, { 6, 2 } });
+      Assert::IsTrue(board.pack(MIRROR) == mirrored.pack());
+      Assert::IsTrue(board.canonical().packed == mirrored.canonical().packed);
+
+      // rotating also swaps the players, their walls and whose turn it is
+      board.doMove({ PLAYER_ONE, DOWN });
+      Board rotated(board.pack(ROTATE_SWAP));
+      Assert::AreEqual(rotated.playerPosition(PLAYER_ONE), Point(4, 0));
+      Assert::AreEqual(rotated.playerPosition(PLAYER_TWO), Point(3, 7));
+      Assert::AreEqual(rotated.wallCount(PLAYER_ONE), 9);
+      Assert::AreEqual(rotated.wallCount(PLAYER_TWO), 10);
+      Assert::AreEqual(rotated.currentPlayer(), PLAYER_ONE);
+      Assert::AreEqual(rotated.walls(), vector<Wall>{ { 6, 5, true } });
+      Assert::IsTrue(rotated.canonical().packed == board.canonical().packed);
+
+      Assert::AreEqual(transformMove({ PLAYER_ONE, DOWN }, ROTATE_SWAP), Move(PLAYER_TWO, UP));
+      Assert::AreEqual(transformMove({ PLAYER_ONE, LEFT }, FLIP_SWAP), Move(PLAYER_TWO, LEFT));
+      Assert::AreEqual(transformMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 0, 3 } }, MIRROR),
+                       Move(PLAYER_TWO, PLACE_HORIZONAL_WALL, { 7, 3 }));
+      Assert::AreEqual(transformMove({ PLAYER_ONE, JUMP_PIECE, { 2, 3 } }, ROTATE_SWAP),
+                       Move(PLAYER_TWO, JUMP_PIECE, { 6, 5 }));
+    }
+
+    TEST_METHOD(TestNoWallMovesWithoutWalls) {
+      Board board;
+      for (int8_t i = 0; i < STARTING_WALL_COUNTS; ++i) {
+        const Point playerOneWall(i % (BOARD_SIZE - 1), i < BOARD_SIZE - 1 ? 1 : 3);
+        const Point playerTwoWall(i % (BOARD_SIZE - 1), i < BOARD_SIZE - 1 ? 5 : 7);
+        board.doMove({ PLAYER_ONE, PLACE_VERTICAL_WALL, playerOneWall });
+        board.doMove({ PLAYER_TWO, PLACE_VERTICAL_WALL, playerTwoWall });
+      }
+      MoveList moves;
+      board.availableMoves(PLAYER_ONE, moves);
+      Assert::IsTrue(all_of(begin(moves), end(moves), [](const Move& m) { return m.type == MOVE_PIECE; }));
+    }
+
+    TEST_METHOD(TestPromisingWalls)
+    {
+      Board board;
+      board.doMove({ PLAYER_ONE, DOWN });
+      board.doMove({ PLAYER_TWO, PLACE_HORIZONAL_WALL, { 2, 2 } });
+
+      for (bool withDistances : { false, true }) {
+        if (withDistances) {
+          board.enableGoalDistances();
+        }
+        MoveList all;
+        MoveList promising;
+        MoveList others;
+        board.availableWallPlacementsForPlayer(PLAYER_ONE, all);
+        board.availableWallPlacementsForPlayer(PLAYER_ONE, promising, PROMISING_WALLS);
+        board.availableWallPlacementsForPlayer(PLAYER_ONE, others, UNPROMISING_WALLS);
+
+        // The two selections split the legal walls between them.
+        vector<Move> split(begin(promising), end(promising));
+        split.insert(split.end(), begin(others), end(others));
+        Assert::AreEqual<size_t>(all.size(), split.size());
+        Assert::IsTrue(sortedMoves(vector<Move>(begin(all), end(all))) == sortedMoves(split));
+
+        auto isPromising = [&](MoveType type, Point center) {
+          return find(begin(promising), end(promising), Move(PLAYER_ONE, type, center)) != end(promising);
+        };
+        // Player two's only shortest route is straight up the middle column.
+        Assert::IsTrue(isPromising(PLACE_HORIZONAL_WALL, { 3, 4 }));
+        Assert::IsTrue(isPromising(PLACE_HORIZONAL_WALL, { 4, 7 }));
+        Assert::IsFalse(isPromising(PLACE_VERTICAL_WALL, { 4, 4 }));
+        // Touching player one's pawn at (4, 1).
+        Assert::IsTrue(isPromising(PLACE_VERTICAL_WALL, { 3, 0 }));
+        // Extending the wall at (2, 2) to the left or upwards from its end.
+        Assert::IsTrue(isPromising(PLACE_HORIZONAL_WALL, { 0, 2 }));
+        Assert::IsTrue(isPromising(PLACE_VERTICAL_WALL, { 1, 2 }));
+        // Far from everything.
+        Assert::IsFalse(isPromising(PLACE_HORIZONAL_WALL, { 0, 6 }));
+        Assert::IsFalse(isPromising(PLACE_VERTICAL_WALL, { 7, 5 }));
+      }
+    }
+
   };
 }
\ No newline at end of file
@@ -0,0 +1,295 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Arena.hpp"
+#include "Board.hpp"
+#include "BoardGeometry.hpp"
+#include "Mcts.hpp"
+#include "MctsEnsemble.hpp"
+#include "Rollout.hpp"
+#include "Util/Random.hpp"
+
+using namespace Quoridor;
+using namespace std;
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+  TEST_CLASS(MctsTest)
+  {
+  public:
+    static Board boardWithPlayerTwoAboutToWin() {
+      // Player one wanders sideways, out of the way, while player two walks up the board.
+      Board board;
+      const Direction playerOneSteps[] = { LEFT, LEFT, RIGHT, LEFT, RIGHT, LEFT, RIGHT, LEFT };
+      for (int i = 0; i < 7; ++i) {
+        board.doMove(Move(PLAYER_ONE, playerOneSteps[i]));
+        board.doMove(Move(PLAYER_TWO, UP));
+      }
+      board.doMove(Move(PLAYER_ONE, playerOneSteps[7]));
+      return board;
+    }
+
+    TEST_METHOD(TestArena)
+    {
+      Arena arena(256);
+      Assert::AreEqual<size_t>(256, arena.capacity());
+      char* byte = static_cast<char*>(arena.allocate(1, 1));
+      Assert::IsNotNull(byte);
+      uint64_t* words = arena.allocateArray<uint64_t>(4);
+      Assert::IsNotNull(words);
+      Assert::AreEqual<uintptr_t>(0, reinterpret_cast<uintptr_t>(words) % alignof(uint64_t));
+      Assert::AreEqual<uint64_t>(0, words[3]);
+      Assert::IsTrue(arena.used() >= 33);
+
+      Assert::IsNull(arena.allocate(1024, 8));
+      arena.reset();
+      Assert::AreEqual<size_t>(0, arena.used());
+      Assert::IsNotNull(arena.allocate(256, 1));
+    }
+
+    TEST_METHOD(TestFindsImmediateWin)
+    {
+      Board board = boardWithPlayerTwoAboutToWin();
+      Assert::IsTrue(Point(4, 1) == board.playerPosition(PLAYER_TWO));
+      Assert::IsTrue(PLAYER_TWO == board.currentPlayer());
+
+      MctsEngine engine(4);
+      MctsLimits limits;
+      limits.maxSimulations = 2000;
+      const MctsResult result = engine.search(board, limits);
+      Assert::IsTrue(Move(PLAYER_TWO, UP) == *result.bestMove);
+      Assert::IsTrue(result.winRate > 0.99);
+    }
+
+    TEST_METHOD(TestReportsUsage)
+    {
+      MctsEngine engine(4);
+      MctsLimits limits;
+      limits.maxSimulations = 500;
+      const MctsResult result = engine.search(Board(), limits);
+      Assert::AreEqual<uint64_t>(500, result.simulations);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      // Every simulation but the ones ending the game adds a node, plus the root.
+      Assert::IsTrue(result.nodes > 1 && result.nodes <= 501);
+      Assert::AreEqual<size_t>(4 << 20, result.arenaCapacity);
+      Assert::IsTrue(result.arenaBytesUsed >= result.nodes * (MctsEngine::nodeSize() + MctsEngine::edgeSize()));
+
+      // The arena starts over on every search.
+      const MctsResult again = engine.search(Board(), limits);
+      Assert::AreEqual(result.arenaBytesUsed, again.arenaBytesUsed);
+    }
+
+    TEST_METHOD(TestParallelFindsImmediateWin)
+    {
+      MctsEngine engine(4, 4);
+      Assert::AreEqual(4, engine.threadCount());
+      MctsLimits limits;
+      limits.maxSimulations = 2000;
+      const MctsResult result = engine.search(boardWithPlayerTwoAboutToWin(), limits);
+      Assert::IsTrue(Move(PLAYER_TWO, UP) == *result.bestMove);
+      Assert::IsTrue(result.winRate > 0.99);
+    }
+
+    TEST_METHOD(TestParallelSharesOneTree)
+    {
+      MctsEngine engine(16, 4);
+      MctsLimits limits;
+      limits.maxSimulations = 3000;
+      const MctsResult result = engine.search(Board(), limits);
+      // The threads draw from one simulation budget and add to one tree.
+      Assert::AreEqual<uint64_t>(3000, result.simulations);
+      Assert::IsTrue(result.nodes > 1 && result.nodes <= 3001);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      Assert::IsTrue(Board().isLegal(*result.bestMove));
+    }
+
+    TEST_METHOD(TestSeedChangesTree)
+    {
+      MctsLimits limits;
+      limits.maxSimulations = 1000;
+      MctsEngine engine(4);
+      engine.setSeed(7);
+      const MctsResult first = engine.search(Board(), limits);
+      const MctsResult again = engine.search(Board(), limits);
+      engine.setSeed(8);
+      const MctsResult other = engine.search(Board(), limits);
+
+      bool sameAsAgain = first.rootMoves.size() == again.rootMoves.size();
+      bool sameAsOther = first.rootMoves.size() == other.rootMoves.size();
+      for (size_t i = 0; i < first.rootMoves.size(); ++i) {
+        sameAsAgain = sameAsAgain && first.rootMoves[i].visits == again.rootMoves[i].visits;
+        sameAsOther = sameAsOther && first.rootMoves[i].visits == other.rootMoves[i].visits;
+      }
+      Assert::IsTrue(sameAsAgain);
+      Assert::IsFalse(sameAsOther);
+    }
+
+    TEST_METHOD(TestEnsembleFindsImmediateWin)
+    {
+      MctsEnsemble ensemble(3, 4);
+      Assert::AreEqual(3, ensemble.treeCount());
+      MctsLimits limits;
+      limits.maxSimulations = 3000;
+      const MctsResult result = ensemble.search(boardWithPlayerTwoAboutToWin(), limits);
+      Assert::IsTrue(Move(PLAYER_TWO, UP) == *result.bestMove);
+      Assert::IsTrue(result.winRate > 0.99);
+    }
+
+    TEST_METHOD(TestEnsembleMergesRootVisits)
+    {
+      MctsEnsemble ensemble(3, 4);
+      MctsLimits limits;
+      limits.maxSimulations = 1000;
+      const MctsResult result = ensemble.search(Board(), limits);
+      Assert::AreEqual<uint64_t>(1000, result.simulations);
+      Assert::AreEqual<size_t>(3 * (4 << 20), result.arenaCapacity);
+
+      // Every simulation in every tree starts with one of the root moves.
+      MoveList legal;
+      Board().availablePieceMovesForPlayer(PLAYER_ONE, legal);
+      Board().availableWallPlacementsForPlayer(PLAYER_ONE, legal);
+      Assert::AreEqual<size_t>(legal.size(), result.rootMoves.size());
+      uint64_t visits = 0;
+      uint32_t mostVisits = 0;
+      uint32_t bestMoveVisits = 0;
+      for (const MctsMoveStats& stats : result.rootMoves) {
+        visits += stats.visits;
+        mostVisits = max(mostVisits, stats.visits);
+        if (stats.move == *result.bestMove) {
+          bestMoveVisits = stats.visits;
+        }
+      }
+      Assert::AreEqual<uint64_t>(1000, visits);
+      Assert::AreEqual(mostVisits, bestMoveVisits);
+    }
+
+    TEST_METHOD(TestRolloutLeafValues)
+    {
+      MctsEngine engine(4);
+      engine.setRolloutPlies(DEFAULT_ROLLOUT_PLIES);
+      MctsLimits limits;
+      limits.maxSimulations = 2000;
+      const MctsResult result = engine.search(boardWithPlayerTwoAboutToWin(), limits);
+      Assert::IsTrue(Move(PLAYER_TWO, UP) == *result.bestMove);
+      Assert::IsTrue(result.winRate > 0.99);
+    }
+
+    TEST_METHOD(TestStopsWhenArenaIsFull)
+    {
+      MctsEngine engine(0);
+      MctsLimits limits;
+      limits.maxSimulations = 1000;
+      const MctsResult result = engine.search(Board(), limits);
+      Assert::AreEqual<uint64_t>(0, result.simulations);
+      Assert::IsFalse(result.bestMove.is_initialized());
+    }
+  };
+  TEST_CLASS(RolloutTest)
+  {
+  public:
+    TEST_METHOD(TestXoshiro)
+    {
+      Random::Xoshiro256 first(42);
+      Random::Xoshiro256 second(42);
+      Random::Xoshiro256 other(43);
+      bool differs = false;
+      for (int i = 0; i < 100; ++i) {
+        const uint64_t value = first.next();
+        Assert::IsTrue(value == second.next());
+        differs = differs || value != other.next();
+        Assert::IsTrue(first.below(7) < 7);
+        const float unit = first.unitFloat();
+        Assert::IsTrue(unit >= 0 && unit < 1);
+        second.below(7);
+        second.unitFloat();
+      }
+      Assert::IsTrue(differs);
+    }
+
+    TEST_METHOD(TestRolloutRestoresBoard)
+    {
+      Board board;
+      board.enableGoalDistances();
+      const PackedBoard before = board.pack();
+      const uint64_t key = board.zobristKey();
+
+      RolloutPolicy policy(1);
+      int finished = 0;
+      for (int i = 0; i < 100; ++i) {
+        const RolloutResult result = policy.play(board);
+        Assert::IsTrue(result.plies > 0 && result.plies <= DEFAULT_ROLLOUT_PLIES);
+        if (result.winner) {
+          ++finished;
+        }
+        Assert::IsTrue(before == board.pack());
+        Assert::AreEqual(key, board.zobristKey());
+        Assert::AreEqual(board.goalDistance(PLAYER_ONE), 8);
+      }
+      // Shortest route stepping finishes nearly every game well inside the limit.
+      Assert::IsTrue(finished >= 90);
+      Assert::IsTrue(policy.pliesPlayed() > 0);
+    }
+
+    TEST_METHOD(TestRolloutTakesTheWin)
+    {
+      Board board = MctsTest::boardWithPlayerTwoAboutToWin();
+      board.enableGoalDistances();
+      RolloutPolicy policy(5);
+      policy.setWallProbability(0);
+      policy.setRandomStepProbability(0);
+      const RolloutResult result = policy.play(board);
+      Assert::IsTrue(PLAYER_TWO == *result.winner);
+      Assert::AreEqual(1, result.plies);
+    }
+
+    TEST_METHOD(TestRolloutWallsCutOpenEdges)
+    {
+      // Wall heavy random games, so plenty of edges around the pawns are walled already.
+      Random::Xoshiro256 random(11);
+      RolloutPolicy policy(3);
+      int walls = 0;
+      for (int game = 0; game < 20; ++game) {
+        Board board;
+        board.enableGoalDistances();
+        for (int ply = 0; ply < 30 && !board.winner(); ++ply) {
+          const Player player = board.currentPlayer();
+          if (board.wallCount(player) > 0) {
+            const boost::optional<Move> wall = policy.chooseWall(board);
+            if (wall) {
+              ++walls;
+              Assert::IsTrue(board.isLegal(*wall));
+              const int opponentCell = cellIndex(board.playerPosition(opponentOf(player)));
+              const uint8_t before = board.wallsState().openDirections(opponentCell);
+              const MoveUndo undo = board.doMove(*wall);
+              Assert::IsTrue(board.wallsState().openDirections(opponentCell) != before);
+              board.undoMove(undo);
+            }
+          }
+          MoveList moves;
+          board.availableMoves(player, moves);
+          board.doMove(moves[random.below(moves.size())]);
+        }
+      }
+      Assert::IsTrue(walls > 100);
+    }
+
+    TEST_METHOD(TestRolloutPlyLimit)
+    {
+      Board board;
+      board.enableGoalDistances();
+      RolloutPolicy policy(9);
+      policy.setWallProbability(0);
+      policy.setRandomStepProbability(0);
+      const RolloutResult result = policy.play(board, 3);
+      Assert::AreEqual(3, result.plies);
+      Assert::IsFalse(result.winner.is_initialized());
+      // Player one has stepped forward twice to player two's once.
+      Assert::IsTrue(result.evaluation > 0);
+    }
+  };
+}
@@ -0,0 +1,728 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Board.hpp"
+#include "Evaluation.hpp"
+#include "Mcts.hpp"
+#include "MoveOrdering.hpp"
+#include "ParallelSearch.hpp"
+#include "PawnRace.hpp"
+#include "Search.hpp"
+#include "SharedTranspositionTable.hpp"
+#include "TimeManager.hpp"
+#include "TranspositionTable.hpp"
+
+using namespace Quoridor;
+using namespace std;
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+  TEST_CLASS(SearchTest)
+  {
+  public:
+    static Board boardWithPlayerOneAboutToWin() {
+      Board board;
+      board.doMove(Move(PLAYER_ONE, DOWN));
+      board.doMove(Move(PLAYER_TWO, LEFT));
+      for (int i = 0; i < 6; ++i) {
+        board.doMove(Move(PLAYER_ONE, DOWN));
+        board.doMove(Move(PLAYER_TWO, UP));
+      }
+      return board;
+    }
+
+    TEST_METHOD(TestFindsImmediateWin)
+    {
+      Board board = boardWithPlayerOneAboutToWin();
+      Assert::IsTrue(Point(4, 7) == board.playerPosition(PLAYER_ONE));
+      Assert::IsTrue(PLAYER_ONE == board.currentPlayer());
+
+      SearchEngine engine;
+      SearchLimits limits;
+      limits.maxDepth = 3;
+      SearchResult result = engine.search(board, limits);
+
+      Assert::IsTrue(result.bestMove.is_initialized());
+      Assert::IsTrue(Move(PLAYER_ONE, DOWN) == *result.bestMove);
+      Assert::AreEqual(WIN_SCORE - 1, result.score);
+      Assert::IsFalse(result.principalVariation.empty());
+      Assert::IsTrue(result.principalVariation.front() == *result.bestMove);
+    }
+
+    TEST_METHOD(TestIterationsReportProgress)
+    {
+      SearchEngine engine;
+      int iterations = 0;
+      int lastDepth = 0;
+      engine.setIterationCallback([&](const SearchResult& result) {
+        ++iterations;
+        Assert::AreEqual(lastDepth + 1, result.depth);
+        Assert::IsTrue(result.bestMove.is_initialized());
+        Assert::IsTrue(result.principalVariation.front() == *result.bestMove);
+        lastDepth = result.depth;
+      });
+
+      SearchLimits limits;
+      limits.maxDepth = 2;
+      SearchResult result = engine.search(Board(), limits);
+      Assert::AreEqual(2, iterations);
+      Assert::AreEqual(2, result.depth);
+      Assert::IsTrue(result.nodes > 0);
+
+      // Every move of the principal variation must be playable in turn.
+      Board board;
+      for (const Move& move : result.principalVariation) {
+        MoveList moves;
+        board.availableMoves(board.currentPlayer(), moves);
+        Assert::IsTrue(find(moves.begin(), moves.end(), move) != moves.end());
+        board.doMove(move);
+      }
+    }
+
+    TEST_METHOD(TestNodeBudgetStopsSearch)
+    {
+      SearchEngine engine;
+      SearchLimits limits;
+      limits.maxNodes = 5000;
+      SearchResult result = engine.search(Board(), limits);
+
+      // The budget is only looked at periodically, so allow one interval of overshoot.
+      Assert::IsTrue(result.nodes <= limits.maxNodes + 1024);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      Assert::IsTrue(result.depth < limits.maxDepth);
+    }
+  };
+
+  TEST_CLASS(TranspositionTableTest)
+  {
+  public:
+    TEST_METHOD(TestMovePacking)
+    {
+      Board board;
+      MoveList moves;
+      board.availableMoves(PLAYER_ONE, moves);
+      board.availableMoves(PLAYER_TWO, moves);
+      moves.push_back(Move(PLAYER_TWO, JUMP_PIECE, Point(4, 2)));
+      for (const Move& move : moves) {
+        const uint16_t packed = packMove(move);
+        Assert::AreNotEqual<int>(0, packed);
+        Assert::IsTrue(move == *unpackMove(packed));
+      }
+      Assert::IsFalse(unpackMove(0).is_initialized());
+    }
+
+    TEST_METHOD(TestStoreAndProbe)
+    {
+      TranspositionTable table(1);
+      Assert::AreEqual<size_t>(1 << 20, table.sizeInBytes());
+      table.newSearch();
+
+      const uint64_t key = Board().zobristKey();
+      TranspositionHit hit;
+      Assert::IsFalse(table.probe(key, 0, hit));
+
+      table.store(key, 0, 5, 120, BOUND_LOWER, Move(PLAYER_ONE, DOWN));
+      Assert::IsTrue(table.probe(key, 0, hit));
+      Assert::AreEqual(5, hit.depth);
+      Assert::AreEqual(120, hit.score);
+      Assert::IsTrue(BOUND_LOWER == hit.bound);
+      Assert::IsTrue(Move(PLAYER_ONE, DOWN) == *hit.move);
+
+      // A shallower inexact result for the same position doesn't displace a deeper one...
+      table.store(key, 0, 3, -40, BOUND_UPPER, boost::none);
+      Assert::IsTrue(table.probe(key, 0, hit));
+      Assert::AreEqual(5, hit.depth);
+
+      // ...but a later search's result does, and keeps the old best move when it has none.
+      table.newSearch();
+      table.store(key, 0, 2, -40, BOUND_UPPER, boost::none);
+      Assert::IsTrue(table.probe(key, 0, hit));
+      Assert::AreEqual(2, hit.depth);
+      Assert::IsTrue(Move(PLAYER_ONE, DOWN) == *hit.move);
+    }
+
+    TEST_METHOD(TestWinScoresAreRelativeToTheNode)
+    {
+      TranspositionTable table(1);
+      const uint64_t key = 0x123456789ABCDEF0ULL;
+      // A win three plies after a node that is itself at ply four.
+      table.store(key, 4, 6, WIN_SCORE - 7, BOUND_EXACT, boost::none);
+
+      TranspositionHit hit;
+      Assert::IsTrue(table.probe(key, 10, hit));
+      Assert::AreEqual(WIN_SCORE - 13, hit.score);
+    }
+
+    TEST_METHOD(TestReplacementPrefersCurrentSearch)
+    {
+      TranspositionTable table(1);
+      // Keys that share the upper half all land in the same bucket.
+      const uint64_t base = 0x0123456700000000ULL;
+      table.newSearch();
+      for (int i = 1; i <= TRANSPOSITION_BUCKET_SIZE; ++i) {
+        table.store(base | i, 0, 5, 0, BOUND_EXACT, boost::none);
+      }
+      table.newSearch();
+      for (int i = 1; i <= TRANSPOSITION_BUCKET_SIZE; ++i) {
+        table.store(base | (0x100 + i), 0, 1, 0, BOUND_EXACT, boost::none);
+      }
+
+      // The deeper but older entries make way for the shallow new ones.
+      TranspositionHit hit;
+      for (int i = 1; i <= TRANSPOSITION_BUCKET_SIZE; ++i) {
+        Assert::IsTrue(table.probe(base | (0x100 + i), 0, hit));
+      }
+    }
+
+    TEST_METHOD(TestSearchAgreesWithTinyTable)
+    {
+      SearchLimits limits;
+      limits.maxDepth = 3;
+      SearchEngine withTable;
+      SearchEngine withTinyTable(0);
+      const SearchResult first = withTable.search(Board(), limits);
+      // A second search of the same position starts from a warm table and must agree.
+      const SearchResult second = withTable.search(Board(), limits);
+      const SearchResult cold = withTinyTable.search(Board(), limits);
+      Assert::AreEqual(first.score, second.score);
+      Assert::AreEqual(first.score, cold.score);
+    }
+  };
+
+  TEST_CLASS(SharedTranspositionTableTest)
+  {
+  public:
+    TEST_METHOD(TestStoreAndProbe)
+    {
+      SharedTranspositionTable table(1);
+      Assert::AreEqual<size_t>(1 << 20, table.sizeInBytes());
+      table.newSearch();
+
+      const uint64_t key = Board().zobristKey();
+      TranspositionHit hit;
+      Assert::IsFalse(table.probe(key, 0, hit));
+      table.store(key, 2, 7, -(WIN_SCORE - 5), BOUND_EXACT, Move(PLAYER_TWO, PLACE_VERTICAL_WALL, Point(3, 6)));
+      Assert::IsTrue(table.probe(key, 2, hit));
+      Assert::AreEqual(7, hit.depth);
+      Assert::AreEqual(-(WIN_SCORE - 5), hit.score);
+      Assert::IsTrue(BOUND_EXACT == hit.bound);
+      Assert::IsTrue(Move(PLAYER_TWO, PLACE_VERTICAL_WALL, Point(3, 6)) == *hit.move);
+
+      // The full key is checked, a key differing only in its low bits misses.
+      Assert::IsFalse(table.probe(key ^ 1, 2, hit));
+    }
+
+    TEST_METHOD(TestConcurrentWritersNeverCorruptProbes)
+    {
+      // Every key is written with a score and depth derived from the key itself, so a probe that
+      // returns anything else has read a torn entry.
+      SharedTranspositionTable table(1);
+      table.newSearch();
+      const uint64_t bucketBits = 0x0123456700000000ULL;
+      const int KEYS = 64;
+      const int ROUNDS = 20000;
+      atomic<int> corrupt(0);
+
+      vector<thread> threads;
+      for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+          TranspositionHit hit;
+          for (int round = 0; round < ROUNDS; ++round) {
+            const uint64_t id = (round * 7 + t * 13) % KEYS + 1;
+            const uint64_t key = bucketBits | (id * 0x9E3779B9ULL & 0xFFFFFFFFULL);
+            if (round % 2 == 0) {
+              table.store(key, 0, static_cast<int>(id), static_cast<int>(id * 3), BOUND_LOWER, boost::none);
+            }
+            else if (table.probe(key, 0, hit) && (hit.depth != static_cast<int>(id) || hit.score != static_cast<int>(id * 3))) {
+              ++corrupt;
+            }
+          }
+        });
+      }
+      for (thread& t : threads) {
+        t.join();
+      }
+      Assert::AreEqual(0, corrupt.load());
+    }
+
+    TEST_METHOD(TestSearchWithSharedTable)
+    {
+      SharedTranspositionTable table(1);
+      table.newSearch();
+      SearchLimits limits;
+      limits.maxDepth = 3;
+      SearchEngine shared(table);
+      SearchEngine own;
+      Assert::AreEqual(own.search(Board(), limits).score, shared.search(Board(), limits).score);
+      Assert::IsTrue(table.hashfull() > 0);
+    }
+  };
+
+  TEST_CLASS(ParallelSearchTest)
+  {
+  public:
+    TEST_METHOD(TestLazySmpFindsImmediateWin)
+    {
+      ParallelSearch search(LAZY_SMP, 4, 1);
+      Assert::AreEqual(4, search.threadCount());
+      SearchLimits limits;
+      limits.maxDepth = 4;
+      const SearchResult result = search.search(SearchTest::boardWithPlayerOneAboutToWin(), limits);
+      Assert::IsTrue(Move(PLAYER_ONE, DOWN) == *result.bestMove);
+      Assert::AreEqual(WIN_SCORE - 1, result.score);
+    }
+
+    TEST_METHOD(TestLazySmpSharesNodeBudget)
+    {
+      ParallelSearch search(LAZY_SMP, 3, 1);
+      SearchLimits limits;
+      limits.maxNodes = 20000;
+      const SearchResult result = search.search(Board(), limits);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      // Each thread may overshoot by up to one check interval.
+      Assert::IsTrue(result.nodes <= limits.maxNodes + 3 * 1024);
+    }
+
+    TEST_METHOD(TestAbdadaSearch)
+    {
+      ParallelSearch parallel(ABDADA, 3, 1);
+      SearchLimits limits;
+      limits.maxDepth = 4;
+      const SearchResult win = parallel.search(SearchTest::boardWithPlayerOneAboutToWin(), limits);
+      Assert::IsTrue(Move(PLAYER_ONE, DOWN) == *win.bestMove);
+      Assert::AreEqual(WIN_SCORE - 1, win.score);
+
+      for (const Board& board : benchmarkPositions()) {
+        const SearchResult result = parallel.search(board, limits);
+        Assert::AreEqual(4, result.depth);
+        MoveList moves;
+        board.availableMoves(board.currentPlayer(), moves);
+        Assert::IsTrue(find(moves.begin(), moves.end(), *result.bestMove) != moves.end());
+      }
+    }
+
+    TEST_METHOD(TestActiveMoveTable)
+    {
+      ActiveMoveTable table;
+      Assert::IsFalse(table.contains(42));
+      table.add(42);
+      Assert::IsTrue(table.contains(42));
+      table.remove(7);
+      Assert::IsTrue(table.contains(42));
+      table.remove(42);
+      Assert::IsFalse(table.contains(42));
+    }
+
+    TEST_METHOD(TestBenchmarkPositionsAreLegal)
+    {
+      for (const Board& board : benchmarkPositions()) {
+        Assert::IsFalse(board.winner().is_initialized());
+        MoveList moves;
+        board.availableMoves(board.currentPlayer(), moves);
+        Assert::IsFalse(moves.empty());
+      }
+    }
+
+    TEST_METHOD(TestScalingReport)
+    {
+      SearchLimits limits;
+      limits.maxDepth = 2;
+      const vector<ScalingSample> samples = measureScaling(parallelSearcher(LAZY_SMP, 1), benchmarkPositions(), { 1, 2 }, limits);
+      Assert::AreEqual<size_t>(2, samples.size());
+      Assert::AreEqual(1, samples[0].threads);
+      Assert::AreEqual(1.0, samples[0].speedup);
+      Assert::IsTrue(samples[1].nodes > 0);
+
+      ostringstream out;
+      out << setprecision(4);
+      writeScalingReport(out, "Lazy SMP", samples);
+      Assert::IsTrue(out.str().find("Lazy SMP") == 0);
+      // The report leaves the stream's own formatting alone.
+      Assert::IsFalse((out.flags() & ios::fixed) != 0);
+      Assert::AreEqual<streamsize>(4, out.precision());
+    }
+  };
+
+  TEST_CLASS(MoveOrderingTest)
+  {
+  public:
+    // Positions with every kind of pawn move: the start, straight jumps and diagonal jumps.
+    static vector<Board> orderingPositions() {
+      vector<Board> positions = benchmarkPositions();
+      Board board;
+      for (int i = 0; i < 3; ++i) {
+        board.doMove(Move(PLAYER_ONE, DOWN));
+        board.doMove(Move(PLAYER_TWO, UP));
+      }
+      // Face to face in the middle column, then with a wall behind player two.
+      board.doMove(Move(PLAYER_ONE, DOWN));
+      positions.push_back(board);
+      board.doMove(Move(PLAYER_TWO, PLACE_HORIZONAL_WALL, Point(4, 5)));
+      positions.push_back(board);
+      return positions;
+    }
+
+    TEST_METHOD(TestMoveIdsRoundTrip)
+    {
+      Assert::AreEqual(140, MOVE_ID_COUNT);
+      int jumps = 0;
+      for (const Board& board : orderingPositions()) {
+        const Player player = board.currentPlayer();
+        const Point from = board.playerPosition(player);
+        MoveList moves;
+        board.availableMoves(player, moves);
+        vector<bool> seen(MOVE_ID_COUNT, false);
+        for (const Move& move : moves) {
+          const MoveId id = moveId(move, from);
+          Assert::IsTrue(id < MOVE_ID_COUNT);
+          Assert::IsFalse(seen[id]);
+          seen[id] = true;
+          Assert::IsTrue(move == moveFromId(id, player, from));
+          jumps += move.type == JUMP_PIECE ? 1 : 0;
+        }
+      }
+      // One straight jump and two diagonal ones.
+      Assert::AreEqual(3, jumps);
+    }
+
+    TEST_METHOD(TestIsLegalMatchesGeneration)
+    {
+      for (const Board& board : orderingPositions()) {
+        const Player player = board.currentPlayer();
+        const Point from = board.playerPosition(player);
+        MoveList moves;
+        board.availableMoves(player, moves);
+        for (int id = 0; id < MOVE_ID_COUNT; ++id) {
+          const Move move = moveFromId(static_cast<MoveId>(id), player, from);
+          const bool generated = find(moves.begin(), moves.end(), move) != moves.end();
+          Assert::AreEqual(generated, board.isLegal(move));
+        }
+        Assert::IsFalse(board.isLegal(Move(opponentOf(player), DOWN)));
+      }
+    }
+
+    TEST_METHOD(TestPickerYieldsEveryMoveOnce)
+    {
+      MoveOrdering ordering;
+      for (Board board : orderingPositions()) {
+        board.enableGoalDistances();
+        const Player player = board.currentPlayer();
+        MoveList moves;
+        board.availableMoves(player, moves);
+
+        // Make a wall a killer and another one the hash move, both should come out early.
+        const Move killer = moves[moves.size() - 1];
+        const Move hash = moves[moves.size() - 2];
+        ordering.addKiller(3, moveId(killer, board.playerPosition(player)));
+        MovePicker picker(board, ordering, 3, hash);
+
+        vector<Move> picked;
+        while (boost::optional<Move> move = picker.next()) {
+          picked.push_back(*move);
+        }
+        Assert::AreEqual<size_t>(moves.size(), picked.size());
+        Assert::IsTrue(hash == picked[0]);
+        sort(picked.begin(), picked.end());
+        Assert::IsTrue(adjacent_find(picked.begin(), picked.end()) == picked.end());
+        for (const Move& move : moves) {
+          Assert::IsTrue(binary_search(picked.begin(), picked.end(), move));
+        }
+      }
+    }
+
+    TEST_METHOD(TestPickerOrdersPawnMovesByDistance)
+    {
+      Board board;
+      board.enableGoalDistances();
+      MoveOrdering ordering;
+      MovePicker picker(board, ordering, 0, boost::none);
+      Assert::IsTrue(Move(PLAYER_ONE, DOWN) == *picker.next());
+    }
+
+    TEST_METHOD(TestHistoryFavoursCutoffMoves)
+    {
+      MoveOrdering ordering;
+      const MoveId tried[] = { 20, 21 };
+      ordering.recordCutoff(PLAYER_ONE, 22, tried, 2, 4);
+      Assert::IsTrue(ordering.historyScore(PLAYER_ONE, 22) > ordering.historyScore(PLAYER_ONE, 20));
+      Assert::AreEqual(0, ordering.historyScore(PLAYER_TWO, 22));
+
+      ordering.addKiller(5, 30);
+      ordering.addKiller(5, 31);
+      Assert::IsTrue(ordering.isKiller(5, 30) && ordering.isKiller(5, 31));
+      ordering.newSearch();
+      Assert::IsFalse(ordering.isKiller(5, 30));
+      Assert::IsTrue(ordering.historyScore(PLAYER_ONE, 22) > 0);
+    }
+
+    TEST_METHOD(TestHistoryOverflowKeepsKillers)
+    {
+      MoveOrdering ordering;
+      ordering.addKiller(5, 30);
+      ordering.recordCutoff(PLAYER_ONE, 20, nullptr, 0, 1);
+      // Move 20 is only tried from here on, each time with a weight of 2^30, so its count is the one
+      // that would wrap around without the halving.
+      const MoveId tried[] = { 20 };
+      for (MoveId best = 21; best < 25; ++best) {
+        ordering.recordCutoff(PLAYER_ONE, best, tried, 1, 32768);
+      }
+      Assert::IsTrue(ordering.historyScore(PLAYER_ONE, 20) < ordering.historyScore(PLAYER_ONE, 21));
+      Assert::IsTrue(ordering.isKiller(5, 30));
+    }
+  };
+  TEST_CLASS(TimeManagerTest)
+  {
+  public:
+    static TimeControl clock(int remainingMilliseconds, int incrementMilliseconds = 0, int movesToGo = 0) {
+      TimeControl control;
+      control.remaining = chrono::milliseconds(remainingMilliseconds);
+      control.increment = chrono::milliseconds(incrementMilliseconds);
+      control.movesToGo = movesToGo;
+      return control;
+    }
+
+    TEST_METHOD(TestDeadlines)
+    {
+      TimeManager time;
+      time.startMove(clock(60000));
+      const auto available = chrono::milliseconds(60000 - 50);
+      Assert::IsTrue(time.softLimit() > EngineClock::duration::zero());
+      Assert::IsTrue(time.softLimit() < time.hardLimit());
+      Assert::IsTrue(time.hardLimit() <= available / 2);
+
+      // An increment buys more time per move.
+      TimeManager withIncrement;
+      withIncrement.startMove(clock(60000, 2000));
+      Assert::IsTrue(withIncrement.softLimit() > time.softLimit());
+
+      // The last move before the clock is topped up can use more, but never the whole clock.
+      TimeManager lastMove;
+      lastMove.startMove(clock(60000, 0, 1));
+      Assert::IsTrue(lastMove.softLimit() > time.softLimit());
+      Assert::IsTrue(lastMove.hardLimit() < available);
+      Assert::IsFalse(lastMove.expired());
+    }
+
+    TEST_METHOD(TestOutOfTime)
+    {
+      // Less on the clock than the overhead leaves nothing to think with.
+      TimeManager time(4);
+      time.startMove(clock(20));
+      Assert::IsTrue(time.hardLimit() == EngineClock::duration::zero());
+      Assert::IsFalse(time.poll(1));
+      Assert::IsTrue(time.poll(4));
+      // Once expired every poll says so, clock or not.
+      Assert::IsTrue(time.poll(5));
+
+      time.startMove(clock(60000));
+      Assert::IsFalse(time.poll(8));
+    }
+
+    TEST_METHOD(TestCheckpoints)
+    {
+      TimeManager time;
+      time.startMove(clock(600000));
+      const Move move(PLAYER_ONE, DOWN);
+      for (int i = 0; i < 5; ++i) {
+        Assert::IsFalse(time.checkpoint(move));
+      }
+      Assert::IsFalse(time.checkpoint(Move(PLAYER_ONE, LEFT)));
+
+      time.startMove(clock(0));
+      Assert::IsTrue(time.checkpoint(move));
+    }
+
+    TEST_METHOD(TestSearchAlwaysHasAMove)
+    {
+      TimeManager time;
+      time.startMove(clock(0));
+      SearchLimits limits;
+      limits.timeManager = &time;
+      SearchEngine engine(1);
+      const SearchResult result = engine.search(Board(), limits);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      Assert::AreEqual(1, result.depth);
+    }
+
+    TEST_METHOD(TestSearchKeepsToDeadline)
+    {
+      TimeManager time;
+      time.startMove(clock(2000));
+      SearchLimits limits;
+      limits.timeManager = &time;
+      ParallelSearch search(LAZY_SMP, 2, 1);
+      const SearchResult result = search.search(Board(), limits);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      Assert::IsTrue(result.depth >= 1);
+      Assert::IsTrue(time.elapsed() < time.hardLimit() + chrono::milliseconds(100));
+    }
+
+    TEST_METHOD(TestMctsKeepsToDeadline)
+    {
+      TimeManager time(64);
+      time.startMove(clock(2000));
+      MctsLimits limits;
+      limits.timeManager = &time;
+      MctsEngine engine(16, 2);
+      const MctsResult result = engine.search(Board(), limits);
+      Assert::IsTrue(result.bestMove.is_initialized());
+      Assert::IsTrue(result.simulations > 0);
+      Assert::IsTrue(time.elapsed() < time.hardLimit() + chrono::milliseconds(100));
+    }
+  };
+  TEST_CLASS(PawnRaceTest)
+  {
+  public:
+    // Uses up the walls on vertical walls, leaving column four a corridor from row 0 to row 7 with
+    // both pawns in it. Player two can keep some walls, stepping left and right on the last row
+    // instead of placing them.
+    static Board corridorBoard(int playerTwoWallsKept = 0) {
+      Board board;
+      const int columns[] = { 1, 3, 4, 6, 0 };
+      const int rows[] = { 0, 2, 4, 6 };
+      int placed = 0;
+      for (int x : columns) {
+        for (int y : rows) {
+          const int playerTwoMovesLeft = (20 - placed) / 2;
+          const bool stepInstead = board.currentPlayer() == PLAYER_TWO && playerTwoMovesLeft < playerTwoWallsKept;
+          const Move move = stepInstead
+            ? Move(PLAYER_TWO, (playerTwoWallsKept - playerTwoMovesLeft) % 2 == 1 ? LEFT : RIGHT)
+            : Move(board.currentPlayer(), PLACE_VERTICAL_WALL, Point(x, y));
+          Assert::IsTrue(board.isLegal(move));
+          board.doMove(move);
+          ++placed;
+        }
+      }
+      return board;
+    }
+
+    TEST_METHOD(TestNeedsWallsGone)
+    {
+      PawnRaceSolver solver;
+      Assert::IsFalse(solver.solve(Board()).is_initialized());
+    }
+
+    TEST_METHOD(TestSolvesCorridorRace)
+    {
+      Board board = corridorBoard();
+      Assert::AreEqual(0, board.wallCount(PLAYER_ONE));
+      Assert::AreEqual(0, board.wallCount(PLAYER_TWO));
+
+      // Player one moves first, but whoever reaches the middle first gets jumped over.
+      PawnRaceSolver solver;
+      const boost::optional<RaceOutcome> outcome = solver.solve(board);
+      Assert::IsTrue(outcome.is_initialized());
+      Assert::IsTrue(PLAYER_TWO == *outcome->winner);
+      Assert::AreEqual(16, outcome->plies);
+      Assert::IsTrue(outcome->exact);
+
+      // Playing the best moves out ends exactly as predicted, every step agreeing.
+      for (int played = 0; played < 16; ++played) {
+        const boost::optional<RaceOutcome> now = solver.solve(board);
+        Assert::IsTrue(PLAYER_TWO == *now->winner);
+        Assert::AreEqual(16 - played, now->plies);
+        Assert::IsTrue(board.isLegal(*now->bestMove));
+        board.doMove(*now->bestMove);
+      }
+      Assert::IsTrue(PLAYER_TWO == *board.winner());
+    }
+
+    // Player one spends every wall on the right hand side, away from both pawns, while player two
+    // takes the ten given steps.
+    static Board playerOneOutOfWalls(const vector<Direction>& playerTwoSteps) {
+      Board board;
+      const int columns[] = { 5, 6, 7 };
+      const int rows[] = { 0, 2, 4, 6 };
+      int placed = 0;
+      for (int x : columns) {
+        for (int y : rows) {
+          if (placed == STARTING_WALL_COUNTS) {
+            break;
+          }
+          const Move wall(PLAYER_ONE, PLACE_VERTICAL_WALL, Point(x, y));
+          Assert::IsTrue(board.isLegal(wall));
+          board.doMove(wall);
+          const Move step(PLAYER_TWO, playerTwoSteps[placed]);
+          Assert::IsTrue(board.isLegal(step));
+          board.doMove(step);
+          ++placed;
+        }
+      }
+      Assert::AreEqual(0, board.wallCount(PLAYER_ONE));
+      Assert::AreEqual(STARTING_WALL_COUNTS, board.wallCount(PLAYER_TWO));
+      return board;
+    }
+
+    TEST_METHOD(TestOpponentHoldingWalls)
+    {
+      PawnRaceSolver solver;
+      // Player two wins the corridor race without walls, but the pawns have to pass each other and
+      // with walls still to come that is not worth building a table for.
+      const Board corridor = corridorBoard(2);
+      Assert::AreEqual(2, corridor.wallCount(PLAYER_TWO));
+      Assert::IsFalse(solver.solve(corridor).is_initialized());
+      const Board losing = corridorBoard(1);
+      Assert::IsTrue(Point(3, 8) == losing.playerPosition(PLAYER_TWO));
+      Assert::IsFalse(solver.solve(losing).is_initialized());
+
+      // Player two is two steps from home on the far side of the board from player one, who cannot
+      // get near enough to interfere.
+      const vector<Direction> steps = { LEFT, LEFT, LEFT, LEFT, UP, UP, UP, UP, UP, UP };
+      const Board outrun = playerOneOutOfWalls(steps);
+      Assert::IsTrue(Point(0, 2) == outrun.playerPosition(PLAYER_TWO));
+      const boost::optional<RaceOutcome> outcome = solver.solve(outrun);
+      Assert::IsTrue(outcome.is_initialized());
+      Assert::IsTrue(PLAYER_TWO == *outcome->winner);
+      Assert::AreEqual(4, outcome->plies);
+      // Player one cannot slow player two down, so player two's walls make no difference.
+      Assert::IsTrue(outcome->exact);
+      Assert::IsTrue(outrun.isLegal(*outcome->bestMove));
+      Assert::AreEqual<uint64_t>(0, solver.tablesBuilt());
+    }
+
+    TEST_METHOD(TestNoTablesWhileOpponentHoldsWalls)
+    {
+      // Every position with player one to move is a race with walls still to come, each with its own
+      // wall layout. None of them may cost a table build. How fast these searches run against the
+      // others is measured on the out of walls benchmark position.
+      const vector<Direction> steps = { LEFT, RIGHT, LEFT, RIGHT, LEFT, RIGHT, LEFT, RIGHT, LEFT, RIGHT };
+      const Board outOfWalls = playerOneOutOfWalls(steps);
+
+      SearchLimits limits;
+      limits.maxNodes = 20000;
+      SearchEngine search(1);
+      const SearchResult searched = search.search(outOfWalls, limits);
+      Assert::IsTrue(searched.nodes >= 20000);
+      Assert::AreEqual<uint64_t>(0, searched.raceTablesBuilt);
+
+      MctsLimits mctsLimits;
+      mctsLimits.maxSimulations = 2000;
+      MctsEngine mcts(16, 1);
+      const MctsResult simulated = mcts.search(outOfWalls, mctsLimits);
+      Assert::AreEqual<uint64_t>(2000, simulated.simulations);
+      Assert::AreEqual<uint64_t>(0, simulated.raceTablesBuilt);
+    }
+
+    TEST_METHOD(TestSearchUsesSolver)
+    {
+      SearchLimits limits;
+      limits.maxDepth = 2;
+      SearchEngine engine(1);
+      const SearchResult result = engine.search(corridorBoard(), limits);
+      // Every reply is solved exactly, so the loss shows at depth 2 though it is 16 plies away.
+      Assert::AreEqual(-(WIN_SCORE - 16), result.score);
+      Assert::IsTrue(result.raceTablesBuilt > 0);
+    }
+  };
+}
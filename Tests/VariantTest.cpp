@@ -0,0 +1,309 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "Board.hpp"
+#include "BoardGeometry.hpp"
+#include "Retrograde.hpp"
+#include "VariantBoard.hpp"
+#include "Util/Random.hpp"
+
+using namespace Quoridor;
+using namespace std;
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+  TEST_CLASS(VariantTest)
+  {
+  public:
+    typedef VariantBoard<9, 10> StandardBoard;
+    typedef VariantBoard<5, 3> SmallBoard;
+
+    template <typename Moves>
+    static vector<Move> sorted(const Moves& moves) {
+      vector<Move> result(moves.begin(), moves.end());
+      sort(result.begin(), result.end());
+      return result;
+    }
+
+    TEST_METHOD(TestTablesAreCompileTime)
+    {
+      static_assert(VariantGeometry<5>::NEIGHBOURS[0 * DIRECTION_COUNT + UP] == -1, "Corner has nothing above");
+      static_assert(VariantGeometry<5>::NEIGHBOURS[0 * DIRECTION_COUNT + RIGHT] == 1, "Corner steps right");
+      static_assert(VariantGeometry<5>::EDGE_BLOCKERS[6 * DIRECTION_COUNT + DOWN] == 0x30, "Two centers below (1, 1)");
+      static_assert(VariantGeometry<7>::ALL_CENTERS == (1ULL << 36) - 1, "6x6 centers");
+      static_assert(VariantGeometry<9>::ALL_CENTERS == ~0ULL, "8x8 centers");
+      static_assert(VariantGeometry<5>::FIRST_CENTER_COLUMN == 0x1111, "First column of 4x4 centers");
+      static_assert(SmallBoard::Dimensions::STARTING_WALL_COUNTS == 3, "Walls per player");
+      static_assert(VariantCells<5>::ROW_CELLS[1].low() == 0x3E0, "Second row of 5x5 squares");
+      static_assert(VariantCells<9>::GOAL_CELLS[PLAYER_ONE].high() == 0x1FF << 8, "Last row straddles both words");
+      static_assert(VariantCells<5>::HORIZONTAL_WALL_CORNERS[0].low() == 0x1C0, "Corners (0, 1) to (2, 1)");
+      Assert::IsTrue(BOARD_SIZE == StandardVariant::BOARD_SIZE);
+    }
+
+    TEST_METHOD(TestStandardGeometryMatches)
+    {
+      const BoardGeometry& geometry = BoardGeometry::instance();
+      for (int cell = 0; cell < CELL_COUNT; ++cell) {
+        Assert::AreEqual(geometry.onBoardDirections(cell), VariantGeometry<9>::onBoardDirections(cell));
+        for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+          Assert::AreEqual(geometry.neighbour(cell, direction), VariantGeometry<9>::neighbour(cell, direction));
+          Assert::AreEqual(geometry.edgeBlockers(cell, direction), VariantGeometry<9>::edgeBlockers(cell, direction));
+        }
+      }
+    }
+
+    TEST_METHOD(TestCellMasks)
+    {
+      typedef VariantCells<9> Cells;
+      const int corners = (BOARD_SIZE + 1) * (BOARD_SIZE + 1);
+      for (int y = 0; y < BOARD_SIZE; ++y) {
+        for (int x = 0; x < BOARD_SIZE; ++x) {
+          const int cell = cellIndex(x, y);
+          Assert::IsTrue(Cells::allCells().test(cell));
+          Assert::IsTrue(Cells::rowCells(y).test(cell));
+          Assert::AreEqual(y == BOARD_SIZE - 1, Cells::goalCells(PLAYER_ONE).test(cell));
+          Assert::AreEqual(y == 0, Cells::goalCells(PLAYER_TWO).test(cell));
+          for (int direction = 0; direction < DIRECTION_COUNT; ++direction) {
+            Assert::AreEqual(VariantGeometry<9>::neighbour(cell, direction) != NO_CELL, Cells::onBoardCells(direction).test(cell));
+          }
+        }
+      }
+      Assert::AreEqual(CELL_COUNT, Cells::allCells().count());
+      Assert::AreEqual(BOARD_SIZE, Cells::rowCells(4).count());
+      for (int corner = 0; corner < corners; ++corner) {
+        const int x = corner % (BOARD_SIZE + 1);
+        const int y = corner / (BOARD_SIZE + 1);
+        Assert::AreEqual(x == 0 || y == 0 || x == BOARD_SIZE || y == BOARD_SIZE, Cells::borderCorners().test(corner));
+      }
+      Assert::AreEqual(4 * BOARD_SIZE, Cells::borderCorners().count());
+      for (int center = 0; center < WALL_CENTER_COUNT; ++center) {
+        const int x = center % WALL_CENTERS_PER_ROW;
+        const int y = center / WALL_CENTERS_PER_ROW;
+        Assert::IsTrue(Cells::horizontalWallCells(center) == (CellMask::cell(cellIndex(x, y)) | CellMask::cell(cellIndex(x + 1, y))));
+        Assert::IsTrue(Cells::verticalWallCells(center) == (CellMask::cell(cellIndex(x, y)) | CellMask::cell(cellIndex(x, y + 1))));
+        CellMask horizontal;
+        CellMask vertical;
+        for (int offset = 0; offset < 3; ++offset) {
+          horizontal.set(x + offset + (y + 1) * (BOARD_SIZE + 1));
+          vertical.set(x + 1 + (y + offset) * (BOARD_SIZE + 1));
+        }
+        Assert::IsTrue(Cells::horizontalWallCorners(center) == horizontal);
+        Assert::IsTrue(Cells::verticalWallCorners(center) == vertical);
+      }
+    }
+
+    TEST_METHOD(TestStandardMovesMatch)
+    {
+      const Move game[] = {
+        Move(PLAYER_ONE, DOWN),
+        Move(PLAYER_TWO, UP),
+        Move(PLAYER_ONE, PLACE_HORIZONAL_WALL, Point(3, 5)),
+        Move(PLAYER_TWO, PLACE_VERTICAL_WALL, Point(4, 2)),
+        Move(PLAYER_ONE, DOWN),
+        Move(PLAYER_TWO, UP),
+        Move(PLAYER_ONE, DOWN),
+        Move(PLAYER_TWO, UP),
+      };
+      Board board;
+      StandardBoard variant;
+      for (const Move& move : game) {
+        MoveList expected;
+        board.availableMoves(board.currentPlayer(), expected);
+        StandardBoard::MoveList moves;
+        variant.availableMoves(moves);
+        Assert::IsTrue(sorted(expected) == sorted(moves));
+
+        board.doMove(move);
+        variant.doMove(move);
+        Assert::AreEqual<int>(cellIndex(board.playerPosition(PLAYER_ONE)), variant.playerCell(PLAYER_ONE));
+        Assert::AreEqual<int>(cellIndex(board.playerPosition(PLAYER_TWO)), variant.playerCell(PLAYER_TWO));
+      }
+      // The pawns now face each other, so the jumps are compared too.
+      MoveList expected;
+      board.availablePieceMovesForPlayer(board.currentPlayer(), expected);
+      StandardBoard::MoveList moves;
+      variant.availablePieceMoves(moves);
+      Assert::IsTrue(sorted(expected) == sorted(moves));
+    }
+
+    TEST_METHOD(TestStandardPlayoutsMatch)
+    {
+      // Random games, half of the moves walls while there are any, must see exactly the same moves in
+      // the same order from both boards at every ply.
+      Random::Xoshiro256 random(24);
+      int jumpPositions = 0;
+      int wallsPlaced = 0;
+      for (int game = 0; game < 40; ++game) {
+        Board board;
+        StandardBoard variant;
+        for (int ply = 0; ply < 150 && !board.winner(); ++ply) {
+          MoveList expected;
+          board.availableMoves(board.currentPlayer(), expected);
+          StandardBoard::MoveList moves;
+          variant.availableMoves(moves);
+          Assert::IsTrue(vector<Move>(expected.begin(), expected.end()) == vector<Move>(moves.begin(), moves.end()));
+          Assert::IsTrue(board.winner() == variant.winner());
+
+          int pieceMoves = 0;
+          while (pieceMoves < expected.size() && (expected[pieceMoves].type == MOVE_PIECE || expected[pieceMoves].type == JUMP_PIECE)) {
+            jumpPositions += expected[pieceMoves].type == JUMP_PIECE;
+            ++pieceMoves;
+          }
+          const bool placeWall = pieceMoves < expected.size() && random.below(2) == 0;
+          const Move move = placeWall
+            ? expected[pieceMoves + random.below(static_cast<uint32_t>(expected.size() - pieceMoves))]
+            : expected[random.below(static_cast<uint32_t>(pieceMoves))];
+          wallsPlaced += placeWall;
+          board.doMove(move);
+          variant.doMove(move);
+          Assert::AreEqual<int>(cellIndex(board.playerPosition(move.player)), variant.playerCell(move.player));
+          Assert::AreEqual(board.wallCount(move.player), variant.wallCount(move.player));
+        }
+        Assert::IsTrue(board.winner() == variant.winner());
+      }
+      Assert::IsTrue(jumpPositions > 0);
+      Assert::IsTrue(wallsPlaced > 500);
+    }
+
+    TEST_METHOD(TestSmallBoard)
+    {
+      SmallBoard board;
+      Assert::AreEqual(2, board.playerCell(PLAYER_ONE));
+      Assert::AreEqual(22, board.playerCell(PLAYER_TWO));
+      Assert::AreEqual(3, board.wallCount(PLAYER_ONE));
+
+      SmallBoard::MoveList moves;
+      board.availableMoves(moves);
+      // Down, left and right, and every one of the 2 * 16 walls.
+      Assert::AreEqual(3 + 32, moves.size());
+
+      // Horizontal walls below the first four squares of the top row leave one way down, on the
+      // right. A vertical wall cutting it off is illegal, one further down is fine.
+      const SmallBoard walled(2, 22, 3, 3, 0x5, 0, PLAYER_ONE);
+      moves.clear();
+      walled.availableWallPlacements(moves);
+      const Move sealing(PLAYER_ONE, PLACE_VERTICAL_WALL, Point(3, 0));
+      const Move lower(PLAYER_ONE, PLACE_VERTICAL_WALL, Point(3, 1));
+      Assert::IsTrue(find(moves.begin(), moves.end(), sealing) == moves.end());
+      Assert::IsTrue(find(moves.begin(), moves.end(), lower) != moves.end());
+
+      board.doMove(Move(PLAYER_ONE, PLACE_HORIZONAL_WALL, Point(0, 1)));
+      Assert::AreEqual(2, board.wallCount(PLAYER_ONE));
+      Assert::IsTrue(PLAYER_TWO == board.currentPlayer());
+      board.undoMove(board.doMove(Move(PLAYER_TWO, UP)));
+      Assert::AreEqual(22, board.playerCell(PLAYER_TWO));
+      Assert::IsTrue(PLAYER_TWO == board.currentPlayer());
+      Assert::IsFalse(board.winner().is_initialized());
+    }
+  };
+
+  TEST_CLASS(RetrogradeTest)
+  {
+  public:
+    typedef VariantBoard<3, 1> TinyBoard;
+    typedef tuple<uint64_t, uint64_t, int, int, int, int, Player> Position;
+
+    // Walks every position reachable from the board and counts those whose value does not follow
+    // from the values of their moves.
+    static int countInconsistent(const RetrogradeTable& table, TinyBoard& board, set<Position>& seen) {
+      const Position position(board.horizontalWalls(), board.verticalWalls(), board.playerCell(PLAYER_ONE),
+        board.playerCell(PLAYER_TWO), board.wallCount(PLAYER_ONE), board.wallCount(PLAYER_TWO), board.currentPlayer());
+      if (!seen.insert(position).second) {
+        return 0;
+      }
+      const GameValue value = table.value(board);
+      if (board.winner()) {
+        return value == VALUE_LOSS ? 0 : 1;
+      }
+      int inconsistent = 0;
+      bool winning = false;
+      bool losing = true;
+      TinyBoard::MoveList moves;
+      board.availableMoves(moves);
+      for (const Move& move : moves) {
+        const TinyBoard::Undo undo = board.doMove(move);
+        const GameValue next = table.value(board);
+        inconsistent += next == VALUE_UNREACHABLE ? 1 : 0;
+        winning = winning || next == VALUE_LOSS;
+        losing = losing && next == VALUE_WIN;
+        inconsistent += countInconsistent(table, board, seen);
+        board.undoMove(undo);
+      }
+      const GameValue expected = winning ? VALUE_WIN : (losing && moves.size() > 0 ? VALUE_LOSS : VALUE_DRAW);
+      return inconsistent + (value == expected ? 0 : 1);
+    }
+
+    TEST_METHOD(TestSolvedValuesAreConsistent)
+    {
+      const string path = "RetrogradeTest_3x3_1.bin";
+      const auto stats = RetrogradeSolver<3, 1>(2).solve(path);
+      Assert::IsTrue(stats.is_initialized());
+      Assert::AreEqual<uint64_t>(29, stats->layouts);
+      Assert::AreEqual<uint64_t>(stats->states, stats->wins + stats->losses + stats->draws + stats->unreachable);
+
+      RetrogradeTable table;
+      Assert::IsTrue(table.open(path));
+      Assert::AreEqual(3, table.boardSize());
+      Assert::AreEqual(1, table.startingWalls());
+
+      TinyBoard board;
+      set<Position> seen;
+      Assert::AreEqual(0, countInconsistent(table, board, seen));
+      Assert::IsTrue(seen.size() > 1000);
+
+      // Whoever steps into the middle first is jumped, so the first player loses even with a wall each.
+      Assert::IsTrue(VALUE_LOSS == table.value(board));
+      // One step from home and to move.
+      const TinyBoard nearlyHome(4, 7, 1, 1, 0, 0, PLAYER_ONE);
+      Assert::IsTrue(VALUE_WIN == table.value(nearlyHome));
+      // Wall counts that do not match the walls on the board.
+      Assert::IsTrue(VALUE_UNREACHABLE == table.value(0, 0, 1, 7, 0, 1, PLAYER_ONE));
+      remove(path.c_str());
+    }
+
+    TEST_METHOD(TestThreadCountsAgree)
+    {
+      const string onePath = "RetrogradeTest_one.bin";
+      const string manyPath = "RetrogradeTest_many.bin";
+      const auto one = RetrogradeSolver<3, 2>(1).solve(onePath);
+      const auto many = RetrogradeSolver<3, 2>(4).solve(manyPath);
+      Assert::IsTrue(one.is_initialized() && many.is_initialized());
+      Assert::AreEqual(one->wins, many->wins);
+      Assert::AreEqual(one->losses, many->losses);
+      Assert::AreEqual(one->draws, many->draws);
+
+      ifstream oneFile(onePath, ios::binary);
+      ifstream manyFile(manyPath, ios::binary);
+      const vector<char> oneBytes((istreambuf_iterator<char>(oneFile)), istreambuf_iterator<char>());
+      const vector<char> manyBytes((istreambuf_iterator<char>(manyFile)), istreambuf_iterator<char>());
+      Assert::AreEqual(one->fileBytes, oneBytes.size());
+      Assert::IsTrue(oneBytes == manyBytes);
+      oneFile.close();
+      manyFile.close();
+      remove(onePath.c_str());
+      remove(manyPath.c_str());
+    }
+
+    TEST_METHOD(TestOpenRejectsOtherFiles)
+    {
+      const string path = "RetrogradeTest_other.bin";
+      {
+        ofstream other(path, ios::binary);
+        other << "not a solved table, just some bytes";
+      }
+      RetrogradeTable table;
+      Assert::IsFalse(table.open(path));
+      Assert::IsFalse(table.open("RetrogradeTest_missing.bin"));
+      remove(path.c_str());
+    }
+  };
+}